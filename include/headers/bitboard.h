@@ -0,0 +1,280 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+// Square indices follow Board::squares: 0 = a8 (top left), 63 = h1 (bottom right).
+typedef uint64_t Bitboard;
+
+enum Direction {
+    NORTH, SOUTH, EAST, WEST, NORTH_EAST, NORTH_WEST, SOUTH_EAST, SOUTH_WEST
+};
+
+// How sliding attacks are looked up. PEXT is a single instruction on Intel
+// Haswell and later and on AMD Zen 3 and later, but microcoded and far slower
+// than a magic multiply on Zen 1 and Zen 2.
+enum SliderBackend {
+    SLIDER_AUTO,
+    SLIDER_MAGIC,
+    SLIDER_PEXT
+};
+
+// Gathers the bits of `source` selected by `mask` into the low bits. Emitted as
+// inline assembly so that the rest of the program does not need -mbmi2 and
+// still runs on hosts without it; only called once PEXT has been selected.
+inline Bitboard Pext(Bitboard source, Bitboard mask) {
+#if defined(__x86_64__)
+    Bitboard result;
+    asm("pextq %2, %1, %0" : "=r"(result) : "r"(source), "r"(mask));
+    return result;
+#else
+    (void)source;
+    (void)mask;
+    return 0;
+#endif
+}
+
+// Slider attack entry for one square. Both backends index the same slice of the
+// attack table: with magics the relevant blockers are multiplied by the magic
+// and the top bits of the product are used, with PEXT the blockers are packed
+// directly. Either way the index stays below 2^popcount(mask).
+struct Magic {
+    Bitboard mask;
+    Bitboard magic;
+    Bitboard* attacks;
+    unsigned shift;
+
+    unsigned Index(Bitboard occupied) const {
+        return unsigned(((occupied & mask) * magic) >> shift);
+    }
+
+    unsigned PextIndex(Bitboard occupied) const {
+        return unsigned(Pext(occupied, mask));
+    }
+};
+
+constexpr Bitboard SquareBB(int square) {
+    return 1ULL << square;
+}
+
+namespace Bitboards {
+
+typedef std::array<Bitboard, 64> SquareTable;
+typedef std::array<SquareTable, 64> SquarePairTable;
+
+// Everything below is evaluated by the compiler; none of it is touched by Init().
+namespace Geometry {
+
+constexpr int rowStep[8] = {-1, 1, 0, 0, -1, -1, 1, 1};
+constexpr int colStep[8] = {0, 0, 1, -1, 1, -1, 1, -1};
+constexpr int opposite[8] = {SOUTH, NORTH, WEST, EAST, SOUTH_WEST, SOUTH_EAST, NORTH_WEST, NORTH_EAST};
+
+constexpr bool OnBoard(int row, int col) {
+    return row >= 0 && row < 8 && col >= 0 && col < 8;
+}
+
+constexpr Bitboard Step(int square, int rowDelta, int colDelta) {
+    int row = square / 8 + rowDelta;
+    int col = square % 8 + colDelta;
+    return OnBoard(row, col) ? SquareBB(row * 8 + col) : 0;
+}
+
+constexpr Bitboard Ray(int square, int direction) {
+    Bitboard ray = 0;
+    int row = square / 8 + rowStep[direction];
+    int col = square % 8 + colStep[direction];
+    while (OnBoard(row, col)) {
+        ray |= SquareBB(row * 8 + col);
+        row += rowStep[direction];
+        col += colStep[direction];
+    }
+    return ray;
+}
+
+constexpr int Sign(int value) {
+    return (value > 0) - (value < 0);
+}
+
+constexpr bool Aligned(int from, int to) {
+    int rowDelta = to / 8 - from / 8;
+    int colDelta = to % 8 - from % 8;
+    return from != to && (rowDelta == 0 || colDelta == 0 || rowDelta == colDelta || rowDelta == -colDelta);
+}
+
+constexpr SquareTable MakeKnightAttacks() {
+    SquareTable table{};
+    for (int s = 0; s < 64; ++s) {
+        table[s] = Step(s, -2, -1) | Step(s, -2, 1) | Step(s, -1, -2) | Step(s, -1, 2)
+                 | Step(s, 1, -2) | Step(s, 1, 2) | Step(s, 2, -1) | Step(s, 2, 1);
+    }
+    return table;
+}
+
+constexpr SquareTable MakeKingAttacks() {
+    SquareTable table{};
+    for (int s = 0; s < 64; ++s) {
+        table[s] = Step(s, -1, -1) | Step(s, -1, 0) | Step(s, -1, 1) | Step(s, 0, -1)
+                 | Step(s, 0, 1) | Step(s, 1, -1) | Step(s, 1, 0) | Step(s, 1, 1);
+    }
+    return table;
+}
+
+// White pawns move towards row 0, black pawns towards row 7.
+constexpr std::array<SquareTable, 2> MakePawnAttacks() {
+    std::array<SquareTable, 2> table{};
+    for (int s = 0; s < 64; ++s) {
+        table[0][s] = Step(s, -1, -1) | Step(s, -1, 1);
+        table[1][s] = Step(s, 1, -1) | Step(s, 1, 1);
+    }
+    return table;
+}
+
+constexpr std::array<SquareTable, 8> MakeRays() {
+    std::array<SquareTable, 8> table{};
+    for (int direction = 0; direction < 8; ++direction) {
+        for (int s = 0; s < 64; ++s) {
+            table[direction][s] = Ray(s, direction);
+        }
+    }
+    return table;
+}
+
+constexpr SquarePairTable MakeBetween() {
+    SquarePairTable table{};
+    for (int from = 0; from < 64; ++from) {
+        for (int to = 0; to < 64; ++to) {
+            if (!Aligned(from, to)) continue;
+            int rowDelta = Sign(to / 8 - from / 8);
+            int colDelta = Sign(to % 8 - from % 8);
+            int square = from + rowDelta * 8 + colDelta;
+            while (square != to) {
+                table[from][to] |= SquareBB(square);
+                square += rowDelta * 8 + colDelta;
+            }
+        }
+    }
+    return table;
+}
+
+constexpr SquarePairTable MakeLine() {
+    SquarePairTable table{};
+    for (int from = 0; from < 64; ++from) {
+        for (int to = 0; to < 64; ++to) {
+            if (!Aligned(from, to)) continue;
+            for (int direction = 0; direction < 8; ++direction) {
+                Bitboard ray = Ray(from, direction);
+                if (ray & SquareBB(to)) {
+                    table[from][to] = ray | Ray(from, opposite[direction]) | SquareBB(from);
+                }
+            }
+        }
+    }
+    return table;
+}
+
+constexpr std::array<std::array<uint8_t, 64>, 64> MakeDistance() {
+    std::array<std::array<uint8_t, 64>, 64> table{};
+    for (int from = 0; from < 64; ++from) {
+        for (int to = 0; to < 64; ++to) {
+            int rowDistance = to / 8 > from / 8 ? to / 8 - from / 8 : from / 8 - to / 8;
+            int colDistance = to % 8 > from % 8 ? to % 8 - from % 8 : from % 8 - to % 8;
+            table[from][to] = uint8_t(rowDistance > colDistance ? rowDistance : colDistance);
+        }
+    }
+    return table;
+}
+
+}
+
+inline constexpr SquareTable KnightAttacks = Geometry::MakeKnightAttacks();
+inline constexpr SquareTable KingAttacks = Geometry::MakeKingAttacks();
+inline constexpr std::array<SquareTable, 2> PawnAttacks = Geometry::MakePawnAttacks();
+inline constexpr std::array<SquareTable, 8> Rays = Geometry::MakeRays();
+// Squares strictly between two aligned squares, and the full line through them;
+// both are empty for squares that share no rank, file or diagonal.
+inline constexpr SquarePairTable Between = Geometry::MakeBetween();
+inline constexpr SquarePairTable Line = Geometry::MakeLine();
+// Chebyshev (king-step) distance between two squares.
+inline constexpr std::array<std::array<uint8_t, 64>, 64> Distance = Geometry::MakeDistance();
+
+static_assert(KnightAttacks[0] == (SquareBB(10) | SquareBB(17)), "knight table");
+static_assert(Between[60][63] == (SquareBB(61) | SquareBB(62)), "between table");
+
+// Every square in `b` moved one step forward for a pawn of colour index Us;
+// white pawns advance towards square 0.
+template<int Us>
+constexpr Bitboard PawnPush(Bitboard b) {
+    return Us == 0 ? b >> 8 : b << 8;
+}
+
+extern Magic RookMagics[64];
+extern Magic BishopMagics[64];
+// Set by Init(); read on every slider lookup, where the branch is always predicted.
+extern bool UsePext;
+
+// Filled in by Init() so callers can report the start-up cost of the tables.
+extern long long InitMicroseconds;
+size_t TableBytes();
+
+// Whether this CPU has BMI2, and whether its PEXT is fast enough to prefer.
+bool CpuHasPext();
+bool CpuHasFastPext();
+// Parses "auto", "magic" or "pext"; returns false for anything else.
+bool ParseSliderBackend(const std::string& name, SliderBackend& backend);
+const char* SliderBackendName();
+
+// Fills the slider tables for the requested backend. SLIDER_AUTO picks PEXT on
+// CPUs where it is fast, and a PEXT request on a CPU without BMI2 falls back to
+// magics. The leaper and geometry tables above need no initialisation.
+void Init(SliderBackend backend = SLIDER_AUTO);
+
+}
+
+inline int PopCount(Bitboard b) {
+    return __builtin_popcountll(b);
+}
+
+inline int Lsb(Bitboard b) {
+    return __builtin_ctzll(b);
+}
+
+inline int Msb(Bitboard b) {
+    return 63 - __builtin_clzll(b);
+}
+
+inline int PopLsb(Bitboard& b) {
+    int square = Lsb(b);
+    b &= b - 1;
+    return square;
+}
+
+// Rays that grow towards higher square indices stop at the lowest blocker,
+// the others at the highest one. Only used to fill the magic tables.
+inline Bitboard RayAttacks(int direction, int square, Bitboard occupied) {
+    Bitboard ray = Bitboards::Rays[direction][square];
+    Bitboard blockers = ray & occupied;
+    if (!blockers) return ray;
+
+    bool increasing = direction == SOUTH || direction == EAST || direction == SOUTH_EAST || direction == SOUTH_WEST;
+    int blocker = increasing ? Lsb(blockers) : Msb(blockers);
+    return ray ^ Bitboards::Rays[direction][blocker];
+}
+
+inline Bitboard BishopAttacks(int square, Bitboard occupied) {
+    const Magic& m = Bitboards::BishopMagics[square];
+    return m.attacks[Bitboards::UsePext ? m.PextIndex(occupied) : m.Index(occupied)];
+}
+
+inline Bitboard RookAttacks(int square, Bitboard occupied) {
+    const Magic& m = Bitboards::RookMagics[square];
+    return m.attacks[Bitboards::UsePext ? m.PextIndex(occupied) : m.Index(occupied)];
+}
+
+inline Bitboard QueenAttacks(int square, Bitboard occupied) {
+    return BishopAttacks(square, occupied) | RookAttacks(square, occupied);
+}
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef BOARD_H
+#define BOARD_H
+
+#include <string>
+#include <type_traits>
+#include "bitboard.h"
+#include "keyhistory.h"
+#include "move.h"
+#include "piece.h"
+#include "zobrist.h"
+
+const int BOARD_SIZE = 8;
+const int TOTAL_SQUARES = BOARD_SIZE * BOARD_SIZE;
+
+enum CastlingRight {
+    WHITE_KINGSIDE = 1,
+    WHITE_QUEENSIDE = 2,
+    BLACK_KINGSIDE = 4,
+    BLACK_QUEENSIDE = 8
+};
+
+// Which moves a generator call produces. Captures include en passant and every
+// promotion; quiets are everything else, castling included. The two together
+// are exactly the legal moves.
+enum GenType {
+    GEN_CAPTURES,
+    GEN_QUIETS,
+    GEN_ALL
+};
+
+// Everything MakeMove overwrites that cannot be recomputed from the move itself.
+// Owned by the caller, typically on the search stack or in Game's history.
+struct UndoInfo {
+    Move move;
+    Piece captured;
+    uint8_t castlingRights;
+    int8_t enPassantSquare;
+    uint16_t halfmoveClock;
+    Key key;
+};
+
+// A position and nothing else: no heap storage and no history, so copying one
+// is a plain memcpy and every thread can own its own.
+class Board {
+public:
+    // byType[t] holds the pieces of type t of both colours; byType[NO_PIECE_TYPE]
+    // holds every occupied square.
+    Bitboard byType[7];
+    Bitboard colours[2];
+    Key key;
+    // Piece on each square, two squares to a byte; read it through PieceOn.
+    uint8_t mailbox[32];
+    // Maintained by SetPiece/RemovePiece so no caller has to search for a king; -1 if absent.
+    int8_t kingSquares[2];
+    Colour currentTurn;
+    uint8_t castlingRights;
+    // Square a pawn skipped over on the last double push if it can be taken en passant, or -1.
+    int8_t enPassantSquare;
+    // Plies since the last capture or pawn move, for the fifty-move rule.
+    uint16_t halfmoveClock;
+    // Starts at 1 and goes up after every black move, as in FEN.
+    uint16_t fullmoveNumber;
+
+    Board();
+
+    Bitboard Occupied() const { return byType[NO_PIECE_TYPE]; }
+    Bitboard Pieces(Colour colour, PieceType type) const { return byType[type] & colours[colour]; }
+    Piece PieceOn(int square) const { return Piece((mailbox[square >> 1] >> ((square & 1) << 2)) & 0xF); }
+
+    void LoadPositionFromFen(const std::string& fen);
+    std::string GetFenFromPosition() const;
+    Key ComputeKey() const;
+    void SwitchTurn();
+
+    void SetPiece(int square, Piece piece);
+    void RemovePiece(int square);
+    void MovePiece(int from, int to);
+
+    // `undo` receives what UnmakeMove needs and must be handed back unchanged.
+    void MakeMove(Move move, UndoInfo& undo);
+    void UnmakeMove(const UndoInfo& undo);
+
+    void GenerateLegalMoves(MoveList& moves) const;
+    void GenerateCaptures(MoveList& moves) const;
+    void GenerateQuiets(MoveList& moves) const;
+    // Whether `move`, e.g. from a hash table or a killer slot, is legal here.
+    bool IsLegal(Move move) const;
+    // Captures and promotions, the moves GenerateCaptures produces.
+    bool IsCapture(Move move) const {
+        return PieceOn(move.To()) != NO_PIECE || move.Flag() == EN_PASSANT || move.Flag() == PROMOTION;
+    }
+    Bitboard AttackersTo(int square, Bitboard occupancy) const;
+    bool IsSquareAttacked(int square, Colour byColour) const;
+    bool IsSquareAttacked(int square, Colour byColour, Bitboard occupancy) const;
+    bool IsKingInCheck(int kingPosition) const;
+    int FindKingPosition() const;
+    bool IsCheckmate() const;
+    bool IsStalemate() const;
+    bool HasInsufficientMaterial() const;
+    // True if the side to move has a reversible move back to a position that
+    // `history` shows fewer than `ply` plies ago, i.e. inside the search tree, so
+    // the search can score the draw before the repetition is on the board.
+    bool HasUpcomingRepetition(const KeyHistory& history, int ply) const;
+    // Static exchange evaluation: whether `move`, followed by the best sequence
+    // of captures on its target square by both sides, wins at least
+    // `threshold` centipawns for the side to move.
+    bool SeeGe(Move move, int threshold) const;
+
+private:
+    void SetMailbox(int square, Piece piece) {
+        int shift = (square & 1) << 2;
+        mailbox[square >> 1] = uint8_t((mailbox[square >> 1] & ~(0xF << shift)) | (piece << shift));
+    }
+
+    template<GenType Type> void Generate(MoveList& moves, Bitboard fromMask) const;
+    template<GenType Type, Colour Us> void GenerateLegalMovesFor(MoveList& moves, Bitboard fromMask) const;
+    template<Colour Us> void GenerateCastlingFor(MoveList& moves, int kingSquare) const;
+    template<Colour Them> bool IsSquareAttackedBy(int square, Bitboard occupancy) const;
+    Bitboard PinnedPieces(Colour us, int kingSquare) const;
+    Bitboard PieceAttacks(PieceType pieceType, int square, Bitboard occupancy) const;
+};
+
+static_assert(std::is_trivially_copyable<Board>::value, "Board must be copyable with memcpy");
+static_assert(sizeof(Board) <= 128, "Board must fit in two cache lines");
+
+std::string SquareToString(int square);
+std::string MoveToString(const Move& move);
+
+#endif
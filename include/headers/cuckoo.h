@@ -0,0 +1,38 @@
+#ifndef CUCKOO_H
+#define CUCKOO_H
+
+#include "move.h"
+#include "zobrist.h"
+
+// Cuckoo hash of every reversible move: a knight, bishop, rook, queen or king
+// of either colour stepping between two squares it attacks on an empty board.
+// Each entry holds the key difference such a move makes, piece out, piece in
+// and side to move flipped, so two keys whose XOR is in the table are one quiet
+// move apart (after Marcel van Kervinck's cycle detection).
+namespace Cuckoo {
+
+const int SIZE = 8192;
+
+extern Key Keys[SIZE];
+extern Move Moves[SIZE];
+
+inline int H1(Key key) { return int(key & (SIZE - 1)); }
+inline int H2(Key key) { return int((key >> 16) & (SIZE - 1)); }
+
+// Index of `moveKey` in the table, or -1.
+inline int Find(Key moveKey) {
+    int slot = H1(moveKey);
+    if (Keys[slot] == moveKey) return slot;
+    slot = H2(moveKey);
+    return Keys[slot] == moveKey ? slot : -1;
+}
+
+// Number of moves placed by the last Init, 3668 for a full table.
+int Count();
+
+// Needs the Zobrist keys, so Zobrist::Init() calls it last.
+void Init();
+
+}
+
+#endif
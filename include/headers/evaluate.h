@@ -0,0 +1,19 @@
+#ifndef EVALUATE_H
+#define EVALUATE_H
+
+#include "board.h"
+
+namespace Eval {
+
+// Indexed by PieceType, in centipawns. Move ordering and SEE score captures
+// with the same values.
+extern const int PieceValue[7];
+
+// Static score of the position in centipawns, from the side to move's point of
+// view: material plus piece-square bonuses, blended between middlegame and
+// endgame king tables by the material left on the board.
+int Evaluate(const Board& board);
+
+}
+
+#endif
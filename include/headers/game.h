@@ -0,0 +1,50 @@
+#ifndef GAME_H
+#define GAME_H
+
+#include <string>
+#include <vector>
+#include "board.h"
+#include "keyhistory.h"
+
+// Room reserved for the undo stack up front; longer games simply grow it.
+const int RESERVED_GAME_PLY = 1024;
+
+// Result of Game::Evaluate, from the point of view of the side to move.
+enum GameStatus {
+    ONGOING,
+    CHECKMATE,
+    STALEMATE,
+    DRAW_FIFTY_MOVES,
+    DRAW_THREEFOLD,
+    DRAW_INSUFFICIENT_MATERIAL
+};
+
+// A board plus the moves that led to it. Board itself holds only the position,
+// so the undo stack and the rules that need the game's history live here.
+class Game {
+public:
+    Board board;
+
+    Game();
+
+    // Starts a new game from `fen`, forgetting all earlier moves.
+    void LoadPositionFromFen(const std::string& fen);
+    void MakeMove(Move move);
+    void UnmakeMove();
+    int MoveCount() const { return int(history.size()); }
+
+    GameStatus Evaluate() const;
+    // True once the current position has occurred `times` times in total since
+    // the last irreversible move.
+    bool IsRepetition(int times) const;
+    // Keys of the positions played so far, for a search to continue from.
+    const KeyHistory& Keys() const { return keys; }
+
+private:
+    std::vector<UndoInfo> history;
+    KeyHistory keys;
+};
+
+std::string GameStatusToString(GameStatus status);
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include "move.h"
+#include "piece.h"
+
+// Scores in every history table stay within [-HISTORY_MAX, HISTORY_MAX].
+const int HISTORY_MAX = 16384;
+
+// Gravity update: the entry moves towards the bound in the direction of
+// `bonus` by a step that shrinks as it nears it, so a score saturates instead
+// of overflowing and old results fade as new ones arrive.
+inline void UpdateHistory(int16_t& entry, int bonus) {
+    if (bonus > HISTORY_MAX) bonus = HISTORY_MAX;
+    if (bonus < -HISTORY_MAX) bonus = -HISTORY_MAX;
+    entry = int16_t(entry + bonus - entry * std::abs(bonus) / HISTORY_MAX);
+}
+
+// Score of a quiet move by the piece that makes it and its target square.
+typedef int16_t PieceToHistory[16][64];
+
+// Quiet-move statistics gathered by one search thread and kept between
+// searches; several MB, so it lives on the heap.
+struct MoveHistory {
+    // Butterfly history, by side to move and the move's from and to squares.
+    int16_t butterfly[2][64][64];
+    // Continuation history: a PieceToHistory for each earlier move, given by
+    // the piece that made it and its target square, scoring the moves that
+    // followed it.
+    PieceToHistory continuation[16][64];
+    // The quiet move that last refuted each move, by the refuted move's piece
+    // and target square.
+    Move counterMoves[16][64];
+
+    void Clear() {
+        std::memset(butterfly, 0, sizeof(butterfly));
+        std::memset(continuation, 0, sizeof(continuation));
+        std::fill(&counterMoves[0][0], &counterMoves[0][0] + 16 * 64, Move());
+    }
+};
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef KEYHISTORY_H
+#define KEYHISTORY_H
+
+#include "zobrist.h"
+
+// Keys of the positions that led to the current one, newest last. Only the
+// stretch since the last capture or pawn move can ever repeat, and the
+// fifty-move rule ends a game before that stretch reaches 100 plies, so a small
+// ring is enough; it is a plain array that a search thread can copy.
+class KeyHistory {
+public:
+    static constexpr int SIZE = 256;
+
+    KeyHistory() : count(0) {}
+
+    void Clear() { count = 0; }
+
+    // Called with the key of the position about to be left by a move.
+    void Push(Key key) {
+        keys[count & (SIZE - 1)] = key;
+        count++;
+    }
+
+    void Pop() { count--; }
+
+    int Size() const { return count; }
+
+    // Key of the position `plies` moves ago, 1 being the one just left;
+    // valid for plies up to min(Size(), SIZE).
+    Key Back(int plies) const { return keys[(count - plies) & (SIZE - 1)]; }
+
+    // True once `key` has occurred `times` times in total, counting the current
+    // occurrence. The same side must be to move, so only every second entry is
+    // compared, back to the last irreversible move given by `halfmoveClock`.
+    bool IsRepetition(Key key, int halfmoveClock, int times) const {
+        int depth = halfmoveClock;
+        if (depth > count) depth = count;
+        if (depth > SIZE) depth = SIZE;
+
+        int found = 1;
+        for (int back = 2; back <= depth; back += 2) {
+            if (keys[(count - back) & (SIZE - 1)] == key && ++found >= times) return true;
+        }
+        return false;
+    }
+
+private:
+    Key keys[SIZE];
+    int count;
+};
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef MOVE_H
+#define MOVE_H
+
+#include <cstdint>
+#include "piece.h"
+
+enum MoveFlag {
+    NORMAL = 0,
+    PROMOTION = 1 << 14,
+    EN_PASSANT = 2 << 14,
+    CASTLING = 3 << 14
+};
+
+// A move packed into 16 bits:
+//   bits 0-5   from square
+//   bits 6-11  to square
+//   bits 12-13 promotion piece minus knight (knight, bishop, rook, queen)
+//   bits 14-15 MoveFlag
+// The all-zero value (a8 to a8) is never a legal move and doubles as "no move".
+class Move {
+public:
+    Move() : data(0) {}
+    Move(int from, int to) : data(uint16_t(from | (to << 6))) {}
+
+    static Move Make(int from, int to, MoveFlag flag, PieceType promotion = KNIGHT) {
+        return Move(uint16_t(from | (to << 6) | ((promotion - KNIGHT) << 12) | flag));
+    }
+
+    // Inverse of Raw(), for moves read back from a hash table.
+    static Move FromRaw(uint16_t raw) { return Move(raw); }
+
+    int From() const { return data & 0x3F; }
+    int To() const { return (data >> 6) & 0x3F; }
+    MoveFlag Flag() const { return MoveFlag(data & (3 << 14)); }
+    // Piece type a pawn promotes to, or NO_PIECE_TYPE.
+    PieceType Promotion() const { return Flag() == PROMOTION ? PieceType(((data >> 12) & 3) + KNIGHT) : NO_PIECE_TYPE; }
+
+    bool IsNone() const { return data == 0; }
+    uint16_t Raw() const { return data; }
+
+    bool operator==(const Move& other) const { return data == other.data; }
+    bool operator!=(const Move& other) const { return data != other.data; }
+
+private:
+    explicit Move(uint16_t raw) : data(raw) {}
+
+    uint16_t data;
+};
+
+static_assert(sizeof(Move) == 2, "Move must stay packed into 16 bits");
+
+// Fixed-capacity move buffer meant to live on the stack; no legal position has
+// more than 218 moves.
+class MoveList {
+public:
+    static const int CAPACITY = 256;
+
+    MoveList() : count(0) {}
+
+    void Add(Move move) {
+        moves[count++] = move;
+    }
+
+    void Clear() { count = 0; }
+    int Size() const { return count; }
+    bool Empty() const { return count == 0; }
+
+    const Move& operator[](int i) const { return moves[i]; }
+    void Set(int i, Move move) { moves[i] = move; }
+    const Move* begin() const { return moves; }
+    const Move* end() const { return moves + count; }
+
+private:
+    Move moves[CAPACITY];
+    int count;
+};
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef MOVEPICKER_H
+#define MOVEPICKER_H
+
+#include "board.h"
+#include "history.h"
+
+// Hands out the legal moves of a position one at a time, most promising first:
+// the hash move, then captures and promotions by MVV/LVA, then the two killer
+// moves and the countermove, then the remaining quiet moves by history score,
+// and last the captures that lose material by static exchange evaluation.
+// Each stage is generated only when the one before it runs dry, so a node that
+// cuts off on an early move never pays for generating the quiet moves.
+class MovePicker {
+public:
+    // `hashMove`, the killers and the countermove may be none or even illegal
+    // here; they are checked before being returned. Quiet moves are ordered by
+    // `history` and by the continuation tables of the previous two moves; any
+    // of those may be null, and without them quiets come in generation order.
+    MovePicker(const Board& board, Move hashMove, Move killer1, Move killer2, Move counterMove = Move(),
+               const MoveHistory* history = nullptr, const PieceToHistory* continuation1 = nullptr,
+               const PieceToHistory* continuation2 = nullptr);
+    // Captures and promotions only, for the quiescence search. Losing captures
+    // are left out altogether.
+    explicit MovePicker(const Board& board);
+
+    // The next move, or a none move once every legal move has been returned.
+    Move Next();
+
+private:
+    enum Stage {
+        HASH_MOVE,
+        GENERATE_CAPTURES,
+        GOOD_CAPTURES,
+        FIRST_KILLER,
+        SECOND_KILLER,
+        COUNTERMOVE,
+        GENERATE_QUIETS,
+        QUIETS,
+        BAD_CAPTURES,
+        DONE
+    };
+
+    // Removes and returns the highest-scoring move left in the list.
+    Move PickBest();
+    bool IsSpecial(Move move) const;
+
+    const Board& board;
+    Move hashMove;
+    Move killers[2];
+    Move counterMove;
+    const MoveHistory* history;
+    const PieceToHistory* continuation[2];
+    int stage;
+    bool capturesOnly;
+    MoveList moves;
+    int scores[MoveList::CAPACITY];
+    int index;
+    // Captures that failed SeeGe(move, 0), in MVV/LVA order.
+    MoveList badCaptures;
+    int badIndex;
+};
+
+#endif
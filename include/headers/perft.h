@@ -0,0 +1,51 @@
+#ifndef PERFT_H
+#define PERFT_H
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include "board.h"
+
+// Number of leaf nodes of the legal move tree `depth` plies below the current position.
+uint64_t Perft(Board& board, int depth);
+
+// Perft split by root move: prints each root move with its subtree count and
+// returns the total.
+uint64_t PerftDivide(Board& board, int depth, std::ostream& out);
+
+// Subtree counts shared by all perft threads without locks. Each slot stores
+// the packed data word and the key XOR data; a torn write from two racing
+// threads fails the XOR check and reads as a miss instead of a wrong count.
+class PerftHash {
+public:
+    explicit PerftHash(size_t megabytes);
+
+    bool Probe(Key key, int depth, uint64_t& nodes) const;
+    void Store(Key key, int depth, uint64_t nodes);
+
+private:
+    struct Entry {
+        std::atomic<uint64_t> check;
+        std::atomic<uint64_t> data;
+    };
+
+    std::unique_ptr<Entry[]> entries;
+    size_t mask;
+};
+
+// Padded to a cache line so threads updating neighbouring entries do not contend.
+struct alignas(64) PerftStats {
+    uint64_t nodes = 0;
+    uint64_t probes = 0;
+    uint64_t hits = 0;
+};
+
+// Splits the root moves across `threads` workers, each on its own copy of the
+// board, sharing `hash` (which may be null). Per-thread stats are returned in
+// `threadStats`, and per-root-move counts are printed when `out` is not null.
+uint64_t ParallelPerft(const Board& board, int depth, int threads, PerftHash* hash,
+                       std::vector<PerftStats>& threadStats, std::ostream* out);
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef PIECE_H
+#define PIECE_H
+
+#include <cstdint>
+
+// Doubles as the index into the per-colour bitboard arrays.
+enum Colour : uint8_t {
+    WHITE = 0,
+    BLACK = 1
+};
+
+constexpr Colour operator~(Colour colour) {
+    return Colour(colour ^ 1);
+}
+
+enum PieceType : uint8_t {
+    NO_PIECE_TYPE = 0,
+    KING = 1,
+    PAWN = 2,
+    KNIGHT = 3,
+    BISHOP = 4,
+    ROOK = 5,
+    QUEEN = 6
+};
+
+// Type in bits 0-2 and colour in bit 3, so a piece fits in a nibble.
+enum Piece : uint8_t {
+    NO_PIECE = 0,
+    W_KING = 1, W_PAWN, W_KNIGHT, W_BISHOP, W_ROOK, W_QUEEN,
+    B_KING = 9, B_PAWN, B_KNIGHT, B_BISHOP, B_ROOK, B_QUEEN
+};
+
+constexpr Piece MakePiece(Colour colour, PieceType type) {
+    return Piece((colour << 3) | type);
+}
+
+constexpr PieceType TypeOf(Piece piece) {
+    return PieceType(piece & 7);
+}
+
+constexpr Colour ColourOf(Piece piece) {
+    return Colour(piece >> 3);
+}
+
+static_assert(MakePiece(BLACK, QUEEN) == B_QUEEN, "piece encoding");
+
+#endif
@@ -0,0 +1,134 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <memory>
+#include <vector>
+#include "board.h"
+#include "history.h"
+#include "keyhistory.h"
+#include "tt.h"
+
+const int MAX_PLY = 128;
+
+const int VALUE_DRAW = 0;
+const int VALUE_MATE = 32000;
+const int VALUE_INFINITE = 32001;
+// Scores beyond this are mates, VALUE_MATE minus the plies to the mate.
+const int VALUE_MATE_IN_MAX_PLY = VALUE_MATE - MAX_PLY;
+
+// Zero means no limit; the search stops at whichever limit it reaches first.
+struct SearchLimits {
+    int depth = MAX_PLY - 1;
+    uint64_t nodes = 0;
+    int64_t milliseconds = 0;
+};
+
+struct SearchResult {
+    Move bestMove;
+    int score = 0;
+    // Last iteration that finished.
+    int depth = 0;
+    uint64_t nodes = 0;
+    double seconds = 0;
+    std::vector<Move> pv;
+    TTStats ttStats;
+    int hashfull = 0;
+    // Beta cutoffs in the main search, and how many of them came from the
+    // first move tried: the share is a direct measure of move ordering.
+    uint64_t cutoffs = 0;
+    uint64_t firstMoveCutoffs = 0;
+
+    uint64_t Nps() const { return seconds > 0 ? uint64_t(nodes / seconds) : 0; }
+    double FirstMoveCutoffRate() const { return cutoffs ? double(firstMoveCutoffs) / cutoffs : 0; }
+};
+
+// One search thread's state: its own copy of the board, key history, killers
+// and history tables, so a search never touches the caller's game or another
+// thread. The PV table alone is a few tens of KB, so keep it on the heap or
+// reuse one. The transposition table is the only thing it shares.
+class Searcher {
+public:
+    // Thread 0 is the main thread: it owns the limits and sets `stopSignal`
+    // when it finishes. Helpers ignore the limits and run until it is set.
+    Searcher(TranspositionTable& tt, int threadId = 0, std::atomic<bool>* stopSignal = nullptr);
+
+    // Iterative deepening from `board`, with `keys` holding the game so far for
+    // repetition checks. Prints a UCI-style info line per iteration to `info`
+    // when it is not null; node counts there are this thread's only. The main
+    // thread always completes depth 1 if there is a legal move.
+    SearchResult Search(const Board& board, const KeyHistory& keys, const SearchLimits& limits,
+                        std::ostream* info = nullptr);
+    // Forgets the history tables, which otherwise carry over between searches.
+    void ClearHistory() { history->Clear(); }
+
+private:
+    int Negamax(int alpha, int beta, int depth, int ply);
+    // Continuation table of the move made `back` plies before `ply`, or null
+    // when that is before the root.
+    PieceToHistory* Continuation(int ply, int back) const;
+    void UpdateQuietHistories(int ply, Move best, const MoveList& quietsTried, int depth);
+    int Quiescence(int alpha, int beta, int ply);
+    bool IsDraw() const;
+    void CheckLimits();
+    double Elapsed() const;
+
+    TranspositionTable& tt;
+    int threadId;
+    std::atomic<bool>* stopSignal;
+    TTStats ttStats;
+    Board board;
+    KeyHistory keys;
+    SearchLimits limits;
+    std::chrono::steady_clock::time_point start;
+    uint64_t nodes;
+    uint64_t cutoffs;
+    uint64_t firstMoveCutoffs;
+    int completedDepth;
+    bool stopped;
+
+    std::unique_ptr<MoveHistory> history;
+    Move killers[MAX_PLY][2];
+    // Move made at each ply of the current line and the piece that made it.
+    Move currentMove[MAX_PLY];
+    Piece movedPiece[MAX_PLY];
+    // Triangular PV table: pv[ply] holds the line from ply onwards.
+    Move pv[MAX_PLY][MAX_PLY];
+    int pvLength[MAX_PLY];
+    // Best move of the last completed iteration, in case the root entry has
+    // been overwritten.
+    Move rootBestMove;
+};
+
+// Lazy SMP: every thread searches the same root on its own board and they
+// cooperate only through the shared transposition table, where each thread
+// finds the others' results. Odd helpers start one iteration deeper so the
+// threads do not all search the same depth in lockstep.
+class SearchPool {
+public:
+    SearchPool(TranspositionTable& tt, int threads);
+
+    void SetThreads(int threads);
+    int Threads() const { return int(searchers.size()); }
+    // Clears the table and every thread's history, e.g. for a new game.
+    void Clear();
+
+    // Searches with every thread and returns the main thread's result, with
+    // nodes and table counters summed over all threads.
+    SearchResult Search(const Board& board, const KeyHistory& keys, const SearchLimits& limits,
+                        std::ostream* info = nullptr);
+
+private:
+    TranspositionTable& tt;
+    std::atomic<bool> stop;
+    std::vector<std::unique_ptr<Searcher>> searchers;
+};
+
+// "cp <n>" or "mate <moves>", as in UCI info lines.
+std::string ScoreToString(int score);
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef TT_H
+#define TT_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include "move.h"
+#include "zobrist.h"
+
+// How a stored score relates to the true value of the position.
+enum Bound : uint8_t {
+    BOUND_NONE = 0,
+    // Fail low: the true value is at most the score.
+    BOUND_UPPER = 1,
+    // Fail high: the true value is at least the score.
+    BOUND_LOWER = 2,
+    BOUND_EXACT = 3
+};
+
+// An entry as the search sees it, unpacked from its 64-bit data word.
+struct TTData {
+    Move move;
+    int score;
+    int depth;
+    Bound bound;
+};
+
+// Per-thread counters, so that searching threads never write to a shared line
+// just to count.
+struct TTStats {
+    uint64_t probes = 0;
+    uint64_t hits = 0;
+    uint64_t stores = 0;
+    // Stores that evicted a different position written during this search.
+    uint64_t collisions = 0;
+};
+
+// Search results shared by every search thread without locks. Each entry
+// stores its data word and the key XOR that word, as PerftHash does, so a
+// torn write from two racing threads fails the check and reads as a miss
+// rather than handing one position another's score.
+//
+// Entries are grouped four to a 64-byte bucket, one cache line, and a key
+// can live in any entry of its bucket, so one probe touches one line.
+class TranspositionTable {
+public:
+    static const int BUCKET_SIZE = 4;
+
+    explicit TranspositionTable(size_t megabytes);
+
+    // Reallocates to the largest power-of-two bucket count that fits and clears it.
+    void Resize(size_t megabytes);
+    void Clear();
+    size_t Megabytes() const { return bucketCount * sizeof(Bucket) / (1024 * 1024); }
+
+    // Call once before each search; entries from earlier searches become the
+    // first to be replaced.
+    void NewSearch() { generation = (generation + 1) & GENERATION_MASK; }
+
+    // Fills `data` and returns true on a hit; leaves it untouched on a miss.
+    // A hit from an earlier search is re-stamped with the current generation.
+    bool Probe(Key key, TTData& data, TTStats& stats);
+    // Scores are stored as given, so mate scores must already be relative to
+    // this node rather than the root.
+    void Store(Key key, Move move, int score, int depth, Bound bound, TTStats& stats);
+
+    // Permille of entries written in the current search, sampled over the first
+    // thousand entries, as in the UCI "hashfull" field.
+    int Hashfull() const;
+
+private:
+    static const int GENERATION_MASK = 0x3F;
+
+    struct Entry {
+        std::atomic<uint64_t> check;
+        std::atomic<uint64_t> data;
+    };
+
+    struct alignas(64) Bucket {
+        Entry entries[BUCKET_SIZE];
+    };
+
+    static_assert(sizeof(Bucket) == 64, "a bucket must fill exactly one cache line");
+
+    // Data word layout:
+    //   bits 0-15  move
+    //   bits 16-31 score (int16)
+    //   bits 32-39 depth (int8)
+    //   bits 40-41 Bound
+    //   bits 42-47 generation
+    static uint64_t Pack(Move move, int score, int depth, Bound bound, int generation);
+    static TTData Unpack(uint64_t data);
+    static int GenerationOf(uint64_t data) { return int(data >> 42) & GENERATION_MASK; }
+
+    Bucket& BucketFor(Key key) { return buckets[key & (bucketCount - 1)]; }
+
+    std::unique_ptr<Bucket[]> buckets;
+    size_t bucketCount;
+    int generation;
+};
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <cstdint>
+
+typedef uint64_t Key;
+
+namespace Zobrist {
+
+extern Key PieceSquare[2][7][64];
+extern Key Castling[16];
+extern Key EnPassantFile[8];
+extern Key SideToMove;
+
+// Also fills the cuckoo tables built from these keys.
+void Init();
+
+}
+
+#endif
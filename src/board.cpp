@@ -0,0 +1,682 @@
+#include "board.h"
+#include "cuckoo.h"
+#include "evaluate.h"
+#include <algorithm>
+#include <iostream>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+namespace {
+
+// ANDed into the castling rights with the from and to squares of every move:
+// touching a king or rook home square clears the matching rights.
+const int castlingRightsMask[64] = {
+    ~BLACK_QUEENSIDE, 15, 15, 15, ~(BLACK_KINGSIDE | BLACK_QUEENSIDE), 15, 15, ~BLACK_KINGSIDE,
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15,
+    ~WHITE_QUEENSIDE, 15, 15, 15, ~(WHITE_KINGSIDE | WHITE_QUEENSIDE), 15, 15, ~WHITE_KINGSIDE
+};
+
+// Indexed by PieceType.
+const char pieceSymbols[] = " kpnbrq";
+
+// Exchange values for SeeGe: the evaluation's piece values, except that the
+// king is never captured, so its value only has to exceed any gain.
+int SeeValue(PieceType type) {
+    return type == KING ? 20000 : Eval::PieceValue[type];
+}
+
+}
+
+std::string SquareToString(int square) {
+    return std::string(1, 'a' + square % BOARD_SIZE) + char('8' - square / BOARD_SIZE);
+}
+
+// Long algebraic notation as used by perft tools and UCI, e.g. "e2e4" or "e7e8q".
+std::string MoveToString(const Move& move) {
+    std::string text = SquareToString(move.From()) + SquareToString(move.To());
+    if (move.Promotion()) text += pieceSymbols[move.Promotion()];
+    return text;
+}
+
+Board::Board() {
+    const std::string startFen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+    LoadPositionFromFen(startFen);
+}
+
+void Board::LoadPositionFromFen(const std::string& fen) {
+    std::memset(this, 0, sizeof(Board));
+    kingSquares[WHITE] = kingSquares[BLACK] = -1;
+
+    std::string fenBoard = fen.substr(0, fen.find(' '));
+    int column = 0, row = 0;
+
+    for (char symbol : fenBoard) {
+        if (symbol == '/') {
+            column = 0;
+            row++;
+        } else {
+            if (isdigit(symbol)) {
+                column += symbol - '0';
+            } else {
+                const char* found = std::strchr(pieceSymbols + 1, tolower(symbol));
+                if (found && column < BOARD_SIZE && row < BOARD_SIZE) {
+                    Colour pieceColour = isupper(symbol) ? WHITE : BLACK;
+                    SetPiece(row * BOARD_SIZE + column, MakePiece(pieceColour, PieceType(found - pieceSymbols)));
+                }
+                column++;
+            }
+        }
+    }
+
+    std::istringstream fields(fen);
+    std::string placement, side = "w", castling = "-", enPassant = "-";
+    int halfmoves = 0, fullmoves = 1;
+    fields >> placement >> side >> castling >> enPassant >> halfmoves >> fullmoves;
+    halfmoveClock = uint16_t(halfmoves > 0 ? std::min(halfmoves, 0xFFFF) : 0);
+    fullmoveNumber = uint16_t(fullmoves > 0 ? std::min(fullmoves, 0xFFFF) : 1);
+
+    currentTurn = (side == "b") ? BLACK : WHITE;
+
+    castlingRights = 0;
+    for (char symbol : castling) {
+        if (symbol == 'K') castlingRights |= WHITE_KINGSIDE;
+        else if (symbol == 'Q') castlingRights |= WHITE_QUEENSIDE;
+        else if (symbol == 'k') castlingRights |= BLACK_KINGSIDE;
+        else if (symbol == 'q') castlingRights |= BLACK_QUEENSIDE;
+    }
+
+    enPassantSquare = -1;
+    if (enPassant.size() == 2 && enPassant[0] >= 'a' && enPassant[0] <= 'h' && enPassant[1] >= '1' && enPassant[1] <= '8') {
+        int square = ('8' - enPassant[1]) * BOARD_SIZE + (enPassant[0] - 'a');
+        if (Bitboards::PawnAttacks[~currentTurn][square] & Pieces(currentTurn, PAWN)) {
+            enPassantSquare = int8_t(square);
+        }
+    }
+
+    key = ComputeKey();
+}
+
+// Full recomputation of the Zobrist key. MakeMove and UnmakeMove keep `key`
+// up to date incrementally; this is only needed after setting up a position.
+Key Board::ComputeKey() const {
+    Key result = 0;
+    Bitboard remaining = Occupied();
+    while (remaining) {
+        int square = PopLsb(remaining);
+        Piece piece = PieceOn(square);
+        result ^= Zobrist::PieceSquare[ColourOf(piece)][TypeOf(piece)][square];
+    }
+
+    if (currentTurn == BLACK) result ^= Zobrist::SideToMove;
+    result ^= Zobrist::Castling[castlingRights];
+    if (enPassantSquare != -1) result ^= Zobrist::EnPassantFile[enPassantSquare % BOARD_SIZE];
+    return result;
+}
+
+std::string Board::GetFenFromPosition() const {
+    std::string fen = "";
+    int emptyCount = 0;
+
+    for (int row = 0; row < BOARD_SIZE; ++row) {
+        for (int col = 0; col < BOARD_SIZE; ++col) {
+            Piece piece = PieceOn(row * BOARD_SIZE + col);
+            if (piece == NO_PIECE) {
+                emptyCount++;
+            } else {
+                if (emptyCount > 0) {
+                    fen += std::to_string(emptyCount);
+                    emptyCount = 0;
+                }
+
+                char pieceChar = pieceSymbols[TypeOf(piece)];
+                if (ColourOf(piece) == WHITE) pieceChar = toupper(pieceChar);
+                fen += pieceChar;
+            }
+        }
+
+        if (emptyCount > 0) {
+            fen += std::to_string(emptyCount);
+            emptyCount = 0;
+        }
+
+        if (row != BOARD_SIZE - 1) fen += '/';
+    }
+
+    fen += (currentTurn == WHITE) ? " w " : " b ";
+
+    std::string castling = "";
+    if (castlingRights & WHITE_KINGSIDE) castling += 'K';
+    if (castlingRights & WHITE_QUEENSIDE) castling += 'Q';
+    if (castlingRights & BLACK_KINGSIDE) castling += 'k';
+    if (castlingRights & BLACK_QUEENSIDE) castling += 'q';
+    fen += castling.empty() ? "-" : castling;
+
+    fen += ' ';
+    fen += (enPassantSquare == -1) ? "-" : SquareToString(enPassantSquare);
+    fen += ' ' + std::to_string(halfmoveClock) + ' ' + std::to_string(fullmoveNumber);
+
+    return fen;
+}
+
+void Board::SwitchTurn() {
+    currentTurn = ~currentTurn;
+    key ^= Zobrist::SideToMove;
+}
+
+void Board::SetPiece(int square, Piece piece) {
+    if (PieceOn(square) != NO_PIECE) {
+        RemovePiece(square);
+    }
+    if (piece == NO_PIECE) return;
+
+    Colour colour = ColourOf(piece);
+    PieceType type = TypeOf(piece);
+    Bitboard bb = SquareBB(square);
+    SetMailbox(square, piece);
+    byType[type] |= bb;
+    byType[NO_PIECE_TYPE] |= bb;
+    colours[colour] |= bb;
+    key ^= Zobrist::PieceSquare[colour][type][square];
+    if (type == KING) kingSquares[colour] = int8_t(square);
+}
+
+void Board::RemovePiece(int square) {
+    Piece piece = PieceOn(square);
+    if (piece == NO_PIECE) return;
+
+    Colour colour = ColourOf(piece);
+    PieceType type = TypeOf(piece);
+    Bitboard bb = SquareBB(square);
+    SetMailbox(square, NO_PIECE);
+    byType[type] &= ~bb;
+    byType[NO_PIECE_TYPE] &= ~bb;
+    colours[colour] &= ~bb;
+    key ^= Zobrist::PieceSquare[colour][type][square];
+    if (type == KING && kingSquares[colour] == square) kingSquares[colour] = -1;
+}
+
+void Board::MovePiece(int from, int to) {
+    Piece piece = PieceOn(from);
+    RemovePiece(from);
+    SetPiece(to, piece);
+}
+
+// Plays a legal move, including the rook hop of castling, the pawn removed by
+// en passant and promotions, and records in `undo` what UnmakeMove needs to
+// revert it.
+void Board::MakeMove(Move move, UndoInfo& undo) {
+    int from = move.From();
+    int to = move.To();
+    MoveFlag flag = move.Flag();
+
+    undo.move = move;
+    undo.captured = PieceOn(to);
+    undo.castlingRights = castlingRights;
+    undo.enPassantSquare = enPassantSquare;
+    undo.halfmoveClock = halfmoveClock;
+    undo.key = key;
+
+    Piece piece = PieceOn(from);
+    PieceType pieceType = TypeOf(piece);
+    Colour colour = ColourOf(piece);
+
+    if (enPassantSquare != -1) {
+        key ^= Zobrist::EnPassantFile[enPassantSquare % BOARD_SIZE];
+    }
+
+    halfmoveClock++;
+    if (pieceType == PAWN || undo.captured != NO_PIECE) {
+        halfmoveClock = 0;
+    }
+
+    if (flag == EN_PASSANT) {
+        int capturedSquare = (colour == WHITE) ? to + BOARD_SIZE : to - BOARD_SIZE;
+        undo.captured = PieceOn(capturedSquare);
+        RemovePiece(capturedSquare);
+    } else if (undo.captured != NO_PIECE) {
+        RemovePiece(to);
+    }
+
+    MovePiece(from, to);
+
+    if (flag == PROMOTION) {
+        SetPiece(to, MakePiece(colour, move.Promotion()));
+    } else if (flag == CASTLING) {
+        if (to > from) MovePiece(from + 3, from + 1);
+        else MovePiece(from - 4, from - 1);
+    }
+
+    // The en passant square is only recorded (and hashed) when an enemy pawn can
+    // actually take on it, so a double push nobody can answer transposes with the
+    // same position reached by single pushes.
+    enPassantSquare = -1;
+    if (pieceType == PAWN && abs(to - from) == 2 * BOARD_SIZE) {
+        int passed = (from + to) / 2;
+        if (Bitboards::PawnAttacks[colour][passed] & Pieces(~colour, PAWN)) {
+            enPassantSquare = int8_t(passed);
+            key ^= Zobrist::EnPassantFile[passed % BOARD_SIZE];
+        }
+    }
+
+    key ^= Zobrist::Castling[castlingRights];
+    castlingRights &= castlingRightsMask[from] & castlingRightsMask[to];
+    key ^= Zobrist::Castling[castlingRights];
+
+    if (colour == BLACK) fullmoveNumber++;
+    SwitchTurn();
+}
+
+void Board::UnmakeMove(const UndoInfo& undo) {
+    Move move = undo.move;
+    int from = move.From();
+    int to = move.To();
+    MoveFlag flag = move.Flag();
+
+    currentTurn = ~currentTurn;
+    Piece piece = PieceOn(to);
+    Colour colour = ColourOf(piece);
+    if (colour == BLACK) fullmoveNumber--;
+
+    RemovePiece(to);
+    SetPiece(from, flag == PROMOTION ? MakePiece(colour, PAWN) : piece);
+
+    if (flag == CASTLING) {
+        if (to > from) MovePiece(from + 1, from + 3);
+        else MovePiece(from - 1, from - 4);
+    }
+
+    if (undo.captured != NO_PIECE) {
+        int capturedSquare = to;
+        if (flag == EN_PASSANT) capturedSquare = (colour == WHITE) ? to + BOARD_SIZE : to - BOARD_SIZE;
+        SetPiece(capturedSquare, undo.captured);
+    }
+
+    castlingRights = undo.castlingRights;
+    enPassantSquare = undo.enPassantSquare;
+    halfmoveClock = undo.halfmoveClock;
+    key = undo.key;
+}
+
+// All legal moves for the side to move, promotions expanded into one entry per
+// piece type. The work is done by the colour-specialised generator below.
+void Board::GenerateLegalMoves(MoveList& moves) const {
+    Generate<GEN_ALL>(moves, ~0ULL);
+}
+
+void Board::GenerateCaptures(MoveList& moves) const {
+    Generate<GEN_CAPTURES>(moves, ~0ULL);
+}
+
+void Board::GenerateQuiets(MoveList& moves) const {
+    Generate<GEN_QUIETS>(moves, ~0ULL);
+}
+
+// Generates only the moves of the piece on the from square rather than every
+// legal move, then looks for `move` among them.
+bool Board::IsLegal(Move move) const {
+    if (move.IsNone()) return false;
+    Piece piece = PieceOn(move.From());
+    if (piece == NO_PIECE || ColourOf(piece) != currentTurn) return false;
+
+    MoveList moves;
+    Generate<GEN_ALL>(moves, SquareBB(move.From()));
+    for (const Move& candidate : moves) {
+        if (candidate == move) return true;
+    }
+    return false;
+}
+
+template<GenType Type>
+void Board::Generate(MoveList& moves, Bitboard fromMask) const {
+    if (currentTurn == WHITE) GenerateLegalMovesFor<Type, WHITE>(moves, fromMask);
+    else GenerateLegalMovesFor<Type, BLACK>(moves, fromMask);
+}
+
+// Checkers and pins are worked out once up front, so apart from king steps and
+// en passant no candidate move has to be tried on the board. With the side fixed
+// at compile time the pawn direction, start and promotion ranks and the castling
+// squares all fold into constants. Only pieces on `fromMask` are considered.
+template<GenType Type, Colour Us>
+void Board::GenerateLegalMovesFor(MoveList& moves, Bitboard fromMask) const {
+    constexpr bool Captures = Type != GEN_QUIETS;
+    constexpr bool Quiets = Type != GEN_CAPTURES;
+    constexpr Colour Them = ~Us;
+    constexpr int Up = (Us == WHITE) ? -BOARD_SIZE : BOARD_SIZE;
+    // Rank a pawn lands on after a single push from its start square.
+    constexpr Bitboard DoublePushRank = (Us == WHITE) ? 0xFFULL << 40 : 0xFFULL << 16;
+    constexpr Bitboard PromotionRank = (Us == WHITE) ? 0xFFULL : 0xFFULL << 56;
+
+    moves.Clear();
+
+    int kingSquare = kingSquares[Us];
+    if (kingSquare == -1) return;
+
+    Bitboard occupied = Occupied();
+    Bitboard king = SquareBB(kingSquare);
+    Bitboard own = colours[Us];
+    Bitboard enemy = colours[Them];
+    Bitboard checkers = AttackersTo(kingSquare, occupied) & enemy;
+    // Squares a non-pawn move may land on for this kind of generation.
+    Bitboard targetMask = (Captures ? enemy : 0) | (Quiets ? ~occupied : 0);
+
+    if (king & fromMask) {
+        // The king must not shield the squares behind it from a slider.
+        Bitboard withoutKing = occupied ^ king;
+        Bitboard kingTargets = Bitboards::KingAttacks[kingSquare] & targetMask;
+        while (kingTargets) {
+            int to = PopLsb(kingTargets);
+            if (!IsSquareAttackedBy<Them>(to, withoutKing)) {
+                moves.Add(Move(kingSquare, to));
+            }
+        }
+    }
+
+    if (PopCount(checkers) > 1) return;
+
+    if (Quiets && !checkers && (king & fromMask)) {
+        GenerateCastlingFor<Us>(moves, kingSquare);
+    }
+
+    // Non-king moves must capture the checker or block its ray.
+    Bitboard checkMask = checkers ? (Bitboards::Between[kingSquare][Lsb(checkers)] | checkers) : ~0ULL;
+    Bitboard pinned = PinnedPieces(Us, kingSquare);
+
+    Bitboard pawns = Pieces(Us, PAWN) & fromMask;
+    Bitboard movers = own & ~king & ~pawns & fromMask;
+    while (movers) {
+        int from = PopLsb(movers);
+        Bitboard targets = PieceAttacks(TypeOf(PieceOn(from)), from, occupied) & targetMask & checkMask;
+        if (pinned & SquareBB(from)) {
+            targets &= Bitboards::Line[kingSquare][from];
+        }
+        while (targets) {
+            moves.Add(Move(from, PopLsb(targets)));
+        }
+    }
+
+    Bitboard empty = ~occupied;
+    while (pawns) {
+        int from = PopLsb(pawns);
+        Bitboard fromBB = SquareBB(from);
+        Bitboard legal = checkMask;
+        if (pinned & fromBB) {
+            legal &= Bitboards::Line[kingSquare][from];
+        }
+
+        // Pushes to the last rank are promotions and so count as captures.
+        Bitboard single = Bitboards::PawnPush<Us>(fromBB) & empty;
+        Bitboard pushes = single | (Bitboards::PawnPush<Us>(single & DoublePushRank) & empty);
+        Bitboard targets = 0;
+        if (Captures) targets |= (Bitboards::PawnAttacks[Us][from] & enemy) | (pushes & PromotionRank);
+        if (Quiets) targets |= pushes & ~PromotionRank;
+        targets &= legal;
+
+        while (targets) {
+            int to = PopLsb(targets);
+            if (SquareBB(to) & PromotionRank) {
+                moves.Add(Move::Make(from, to, PROMOTION, QUEEN));
+                moves.Add(Move::Make(from, to, PROMOTION, ROOK));
+                moves.Add(Move::Make(from, to, PROMOTION, BISHOP));
+                moves.Add(Move::Make(from, to, PROMOTION, KNIGHT));
+            } else {
+                moves.Add(Move(from, to));
+            }
+        }
+
+        // En passant removes two pieces from one rank, which the pin mask cannot
+        // describe, so it is the one move still verified against the occupancy.
+        if (Captures && enPassantSquare != -1 && (Bitboards::PawnAttacks[Us][from] & SquareBB(enPassantSquare))) {
+            int capturedSquare = enPassantSquare - Up;
+            Bitboard occupancy = (occupied ^ fromBB ^ SquareBB(capturedSquare)) | SquareBB(enPassantSquare);
+            if (!(AttackersTo(kingSquare, occupancy) & enemy & ~SquareBB(capturedSquare))) {
+                moves.Add(Move::Make(from, enPassantSquare, EN_PASSANT));
+            }
+        }
+    }
+}
+
+template<Colour Us>
+void Board::GenerateCastlingFor(MoveList& moves, int kingSquare) const {
+    constexpr Colour Them = ~Us;
+    constexpr int KingHome = (Us == WHITE) ? 60 : 4;
+    constexpr int Kingside = (Us == WHITE) ? WHITE_KINGSIDE : BLACK_KINGSIDE;
+    constexpr int Queenside = (Us == WHITE) ? WHITE_QUEENSIDE : BLACK_QUEENSIDE;
+    constexpr Bitboard KingsidePath = SquareBB(KingHome + 1) | SquareBB(KingHome + 2);
+    constexpr Bitboard QueensidePath = SquareBB(KingHome - 1) | SquareBB(KingHome - 2) | SquareBB(KingHome - 3);
+
+    // Rights read from a hand-written FEN are not checked against the king's square.
+    if (kingSquare != KingHome) return;
+
+    Bitboard occupied = Occupied();
+    if ((castlingRights & Kingside)
+        && !(occupied & KingsidePath)
+        && !IsSquareAttackedBy<Them>(KingHome + 1, occupied)
+        && !IsSquareAttackedBy<Them>(KingHome + 2, occupied)) {
+        moves.Add(Move::Make(KingHome, KingHome + 2, CASTLING));
+    }
+    if ((castlingRights & Queenside)
+        && !(occupied & QueensidePath)
+        && !IsSquareAttackedBy<Them>(KingHome - 1, occupied)
+        && !IsSquareAttackedBy<Them>(KingHome - 2, occupied)) {
+        moves.Add(Move::Make(KingHome, KingHome - 2, CASTLING));
+    }
+}
+
+// Our pieces that are the only blocker between our king and an enemy slider.
+Bitboard Board::PinnedPieces(Colour us, int kingSquare) const {
+    Colour them = ~us;
+    Bitboard snipers = (RookAttacks(kingSquare, 0) & (Pieces(them, ROOK) | Pieces(them, QUEEN)))
+                     | (BishopAttacks(kingSquare, 0) & (Pieces(them, BISHOP) | Pieces(them, QUEEN)));
+    Bitboard pinned = 0;
+    while (snipers) {
+        Bitboard blockers = Bitboards::Between[kingSquare][PopLsb(snipers)] & Occupied();
+        if (PopCount(blockers) == 1) {
+            pinned |= blockers & colours[us];
+        }
+    }
+    return pinned;
+}
+
+Bitboard Board::PieceAttacks(PieceType pieceType, int square, Bitboard occupancy) const {
+    switch (pieceType) {
+        case KING: return Bitboards::KingAttacks[square];
+        case KNIGHT: return Bitboards::KnightAttacks[square];
+        case BISHOP: return BishopAttacks(square, occupancy);
+        case ROOK: return RookAttacks(square, occupancy);
+        case QUEEN: return QueenAttacks(square, occupancy);
+        default: return 0;
+    }
+}
+
+// Every piece of either colour attacking `square`, given the occupancy used to block sliders.
+Bitboard Board::AttackersTo(int square, Bitboard occupancy) const {
+    Bitboard bishopsQueens = byType[BISHOP] | byType[QUEEN];
+    Bitboard rooksQueens = byType[ROOK] | byType[QUEEN];
+
+    return ((Bitboards::PawnAttacks[BLACK][square] & Pieces(WHITE, PAWN))
+          | (Bitboards::PawnAttacks[WHITE][square] & Pieces(BLACK, PAWN))
+          | (Bitboards::KnightAttacks[square] & byType[KNIGHT])
+          | (Bitboards::KingAttacks[square] & byType[KING])
+          | (BishopAttacks(square, occupancy) & bishopsQueens)
+          | (RookAttacks(square, occupancy) & rooksQueens)) & occupancy;
+}
+
+bool Board::IsSquareAttacked(int square, Colour byColour) const {
+    return IsSquareAttacked(square, byColour, Occupied());
+}
+
+bool Board::IsSquareAttacked(int square, Colour byColour, Bitboard occupancy) const {
+    return byColour == WHITE ? IsSquareAttackedBy<WHITE>(square, occupancy) : IsSquareAttackedBy<BLACK>(square, occupancy);
+}
+
+// Works backwards from `square`: a piece of type X attacks it exactly when an X
+// standing on `square` would attack that piece. The cheap leaper tests come
+// first and each test returns as soon as it finds an attacker.
+template<Colour Them>
+bool Board::IsSquareAttackedBy(int square, Bitboard occupancy) const {
+    Bitboard enemy = colours[Them];
+
+    if (Bitboards::PawnAttacks[~Them][square] & byType[PAWN] & enemy) return true;
+    if (Bitboards::KnightAttacks[square] & byType[KNIGHT] & enemy) return true;
+    if (Bitboards::KingAttacks[square] & byType[KING] & enemy) return true;
+
+    Bitboard bishopsQueens = (byType[BISHOP] | byType[QUEEN]) & enemy;
+    if (bishopsQueens && (BishopAttacks(square, occupancy) & bishopsQueens)) return true;
+
+    Bitboard rooksQueens = (byType[ROOK] | byType[QUEEN]) & enemy;
+    return rooksQueens && (RookAttacks(square, occupancy) & rooksQueens);
+}
+
+bool Board::IsKingInCheck(int kingPosition) const {
+    return IsSquareAttacked(kingPosition, ~currentTurn);
+}
+
+int Board::FindKingPosition() const {
+    return kingSquares[currentTurn];
+}
+
+bool Board::IsCheckmate() const {
+    int kingPosition = FindKingPosition();
+    if (kingPosition == -1) {
+        std::cerr << "Error: King not found on the board." << std::endl;
+        return false;
+    }
+
+    if (!IsKingInCheck(kingPosition)) {
+        return false;
+    }
+
+    MoveList moves;
+    GenerateLegalMoves(moves);
+    if (!moves.Empty()) {
+        std::cout << "Found a valid move from " << moves[0].From() << " to " << moves[0].To() << ". Not checkmate." << std::endl;
+        return false;
+    }
+
+    std::cout << "No valid moves found. Checkmate!" << std::endl;
+    return true;
+}
+
+bool Board::IsStalemate() const {
+    int kingPosition = FindKingPosition();
+    if (kingPosition == -1) {
+        std::cerr << "Error: King not found on the board." << std::endl;
+        return false;
+    }
+
+    if (IsKingInCheck(kingPosition)) {
+        return false;
+    }
+
+    MoveList moves;
+    GenerateLegalMoves(moves);
+    return moves.Empty();
+}
+
+// Bare kings, a single minor piece, or bishops that all stand on one colour of
+// square can never deliver mate.
+bool Board::HasInsufficientMaterial() const {
+    const Bitboard lightSquares = 0xAA55AA55AA55AA55ULL;
+
+    if (byType[PAWN] | byType[ROOK] | byType[QUEEN]) return false;
+
+    Bitboard knights = byType[KNIGHT];
+    Bitboard bishops = byType[BISHOP];
+    if (PopCount(knights | bishops) <= 1) return true;
+
+    return !knights && (!(bishops & lightSquares) || !(bishops & ~lightSquares));
+}
+
+// The key difference to each earlier position with the same side to move would
+// be a single reversible move exactly when the cuckoo table holds it; the move
+// is then playable if nothing stands between its two squares.
+bool Board::HasUpcomingRepetition(const KeyHistory& history, int ply) const {
+    int end = std::min(std::min<int>(halfmoveClock, history.Size()), KeyHistory::SIZE);
+    if (end < 3) return false;
+
+    Bitboard occupied = Occupied();
+    for (int back = 3; back <= end; back += 2) {
+        int slot = Cuckoo::Find(key ^ history.Back(back));
+        if (slot < 0) continue;
+
+        Move move = Cuckoo::Moves[slot];
+        if (Bitboards::Between[move.From()][move.To()] & occupied) continue;
+
+        // A cycle that reaches back past the root repeats a game position only
+        // once, which is not yet a draw; leave those to the real repetition check.
+        if (ply > back) return true;
+    }
+    return false;
+}
+
+// Swap algorithm: the two sides take turns recapturing on the target square
+// with their least valuable attacker, and `swap` tracks how far the balance is
+// from the threshold. Sliders behind a piece that has just captured join in
+// through the updated occupancy. Pins and recaptures that promote are ignored.
+bool Board::SeeGe(Move move, int threshold) const {
+    if (move.Flag() == CASTLING) return threshold <= 0;
+
+    int from = move.From();
+    int to = move.To();
+    PieceType moved = TypeOf(PieceOn(from));
+    PieceType captured = move.Flag() == EN_PASSANT ? PAWN : TypeOf(PieceOn(to));
+    Bitboard occupied = Occupied() ^ SquareBB(from) ^ SquareBB(to);
+    if (move.Flag() == EN_PASSANT) {
+        occupied ^= SquareBB(to + (currentTurn == WHITE ? 8 : -8));
+    }
+    if (move.Flag() == PROMOTION) {
+        moved = move.Promotion();
+        threshold += SeeValue(PAWN) - SeeValue(moved);
+    }
+
+    int swap = SeeValue(captured) - threshold;
+    if (swap < 0) return false;
+
+    // Even losing the moved piece for nothing keeps the balance at the threshold.
+    swap = SeeValue(moved) - swap;
+    if (swap <= 0) return true;
+
+    Colour side = currentTurn;
+    Bitboard attackers = AttackersTo(to, occupied);
+    Bitboard bishopsQueens = byType[BISHOP] | byType[QUEEN];
+    Bitboard rooksQueens = byType[ROOK] | byType[QUEEN];
+    bool result = true;
+
+    while (true) {
+        side = ~side;
+        attackers &= occupied;
+        Bitboard sideAttackers = attackers & colours[side];
+        if (!sideAttackers) break;
+        result = !result;
+
+        PieceType attacker = PAWN;
+        while (attacker <= QUEEN && !(sideAttackers & byType[attacker])) {
+            attacker = PieceType(attacker + 1);
+        }
+
+        // The king may only take last: while the other side still has an
+        // attacker, capturing with it would be illegal.
+        if (attacker > QUEEN) {
+            return (attackers & colours[~side]) ? !result : result;
+        }
+
+        swap = SeeValue(attacker) - swap;
+        if (swap < int(result)) break;
+
+        occupied ^= SquareBB(Lsb(sideAttackers & byType[attacker]));
+        if (attacker == PAWN || attacker == BISHOP || attacker == QUEEN) {
+            attackers |= BishopAttacks(to, occupied) & bishopsQueens;
+        }
+        if (attacker == ROOK || attacker == QUEEN) {
+            attackers |= RookAttacks(to, occupied) & rooksQueens;
+        }
+    }
+    return result;
+}
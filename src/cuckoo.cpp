@@ -0,0 +1,68 @@
+#include "cuckoo.h"
+#include <utility>
+#include "bitboard.h"
+
+namespace Cuckoo {
+
+Key Keys[SIZE];
+Move Moves[SIZE];
+
+namespace {
+
+int count = 0;
+
+// Attacks on an empty board, so the magic tables need not be ready yet.
+Bitboard EmptyBoardAttacks(int pieceType, int square) {
+    using namespace Bitboards;
+    Bitboard diagonal = Rays[NORTH_EAST][square] | Rays[NORTH_WEST][square] | Rays[SOUTH_EAST][square] | Rays[SOUTH_WEST][square];
+    Bitboard straight = Rays[NORTH][square] | Rays[SOUTH][square] | Rays[EAST][square] | Rays[WEST][square];
+    switch (pieceType) {
+        case KING: return KingAttacks[square];
+        case KNIGHT: return KnightAttacks[square];
+        case BISHOP: return diagonal;
+        case ROOK: return straight;
+        case QUEEN: return diagonal | straight;
+        default: return 0;
+    }
+}
+
+}
+
+int Count() {
+    return count;
+}
+
+void Init() {
+    for (int i = 0; i < SIZE; ++i) {
+        Keys[i] = 0;
+        Moves[i] = Move();
+    }
+    count = 0;
+
+    const PieceType types[] = {KING, KNIGHT, BISHOP, ROOK, QUEEN};
+    for (int colour = 0; colour < 2; ++colour) {
+        for (PieceType type : types) {
+            for (int from = 0; from < 64; ++from) {
+                for (int to = from + 1; to < 64; ++to) {
+                    if (!(EmptyBoardAttacks(type, from) & SquareBB(to))) continue;
+
+                    Key key = Zobrist::PieceSquare[colour][type][from] ^ Zobrist::PieceSquare[colour][type][to] ^ Zobrist::SideToMove;
+                    Move move(from, to);
+
+                    // Kick out whatever sits in this entry's slot and move it to
+                    // its other slot until an empty one turns up.
+                    int slot = H1(key);
+                    while (true) {
+                        std::swap(Keys[slot], key);
+                        std::swap(Moves[slot], move);
+                        if (move.IsNone()) break;
+                        slot = (slot == H1(key)) ? H2(key) : H1(key);
+                    }
+                    count++;
+                }
+            }
+        }
+    }
+}
+
+}
@@ -0,0 +1,125 @@
+#include "evaluate.h"
+
+namespace Eval {
+
+const int PieceValue[7] = {0, 0, 100, 320, 330, 500, 900};
+
+namespace {
+
+// Piece-square tables from White's side, laid out like Board::squares with a8
+// first; Black's bonus for a square is read from its mirror, square ^ 56.
+const int pawnTable[64] = {
+     0,   0,   0,   0,   0,   0,   0,   0,
+    50,  50,  50,  50,  50,  50,  50,  50,
+    10,  10,  20,  30,  30,  20,  10,  10,
+     5,   5,  10,  25,  25,  10,   5,   5,
+     0,   0,   0,  20,  20,   0,   0,   0,
+     5,  -5, -10,   0,   0, -10,  -5,   5,
+     5,  10,  10, -20, -20,  10,  10,   5,
+     0,   0,   0,   0,   0,   0,   0,   0
+};
+
+const int knightTable[64] = {
+   -50, -40, -30, -30, -30, -30, -40, -50,
+   -40, -20,   0,   0,   0,   0, -20, -40,
+   -30,   0,  10,  15,  15,  10,   0, -30,
+   -30,   5,  15,  20,  20,  15,   5, -30,
+   -30,   0,  15,  20,  20,  15,   0, -30,
+   -30,   5,  10,  15,  15,  10,   5, -30,
+   -40, -20,   0,   5,   5,   0, -20, -40,
+   -50, -40, -30, -30, -30, -30, -40, -50
+};
+
+const int bishopTable[64] = {
+   -20, -10, -10, -10, -10, -10, -10, -20,
+   -10,   0,   0,   0,   0,   0,   0, -10,
+   -10,   0,   5,  10,  10,   5,   0, -10,
+   -10,   5,   5,  10,  10,   5,   5, -10,
+   -10,   0,  10,  10,  10,  10,   0, -10,
+   -10,  10,  10,  10,  10,  10,  10, -10,
+   -10,   5,   0,   0,   0,   0,   5, -10,
+   -20, -10, -10, -10, -10, -10, -10, -20
+};
+
+const int rookTable[64] = {
+     0,   0,   0,   0,   0,   0,   0,   0,
+     5,  10,  10,  10,  10,  10,  10,   5,
+    -5,   0,   0,   0,   0,   0,   0,  -5,
+    -5,   0,   0,   0,   0,   0,   0,  -5,
+    -5,   0,   0,   0,   0,   0,   0,  -5,
+    -5,   0,   0,   0,   0,   0,   0,  -5,
+    -5,   0,   0,   0,   0,   0,   0,  -5,
+     0,   0,   0,   5,   5,   0,   0,   0
+};
+
+const int queenTable[64] = {
+   -20, -10, -10,  -5,  -5, -10, -10, -20,
+   -10,   0,   0,   0,   0,   0,   0, -10,
+   -10,   0,   5,   5,   5,   5,   0, -10,
+    -5,   0,   5,   5,   5,   5,   0,  -5,
+     0,   0,   5,   5,   5,   5,   0,  -5,
+   -10,   5,   5,   5,   5,   5,   0, -10,
+   -10,   0,   5,   0,   0,   0,   0, -10,
+   -20, -10, -10,  -5,  -5, -10, -10, -20
+};
+
+const int kingMiddlegameTable[64] = {
+   -30, -40, -40, -50, -50, -40, -40, -30,
+   -30, -40, -40, -50, -50, -40, -40, -30,
+   -30, -40, -40, -50, -50, -40, -40, -30,
+   -30, -40, -40, -50, -50, -40, -40, -30,
+   -20, -30, -30, -40, -40, -30, -30, -20,
+   -10, -20, -20, -20, -20, -20, -20, -10,
+    20,  20,   0,   0,   0,   0,  20,  20,
+    20,  30,  10,   0,   0,  10,  30,  20
+};
+
+const int kingEndgameTable[64] = {
+   -50, -40, -30, -20, -20, -30, -40, -50,
+   -30, -20, -10,   0,   0, -10, -20, -30,
+   -30, -10,  20,  30,  30,  20, -10, -30,
+   -30, -10,  30,  40,  40,  30, -10, -30,
+   -30, -10,  30,  40,  40,  30, -10, -30,
+   -30, -10,  20,  30,  30,  20, -10, -30,
+   -30, -30,   0,   0,   0,   0, -30, -30,
+   -50, -30, -30, -30, -30, -30, -30, -50
+};
+
+// Indexed by PieceType; the king is handled separately.
+const int* const pieceTables[7] = {nullptr, nullptr, pawnTable, knightTable, bishopTable, rookTable, queenTable};
+
+// Phase weight of each piece type; 24 with all minors, rooks and queens on.
+const int phaseWeight[7] = {0, 0, 0, 1, 1, 2, 4};
+const int MAX_PHASE = 24;
+
+}
+
+int Evaluate(const Board& board) {
+    int score[2] = {0, 0};
+    int phase = 0;
+
+    for (int colour = WHITE; colour <= BLACK; ++colour) {
+        int flip = (colour == WHITE) ? 0 : 56;
+        for (int type = PAWN; type <= QUEEN; ++type) {
+            Bitboard pieces = board.Pieces(Colour(colour), PieceType(type));
+            phase += phaseWeight[type] * PopCount(pieces);
+            while (pieces) {
+                int square = PopLsb(pieces);
+                score[colour] += PieceValue[type] + pieceTables[type][square ^ flip];
+            }
+        }
+    }
+
+    if (phase > MAX_PHASE) phase = MAX_PHASE;
+    for (int colour = WHITE; colour <= BLACK; ++colour) {
+        int king = board.kingSquares[colour];
+        if (king == -1) continue;
+        int square = king ^ ((colour == WHITE) ? 0 : 56);
+        score[colour] += (kingMiddlegameTable[square] * phase + kingEndgameTable[square] * (MAX_PHASE - phase)) / MAX_PHASE;
+    }
+
+    int whiteScore = score[WHITE] - score[BLACK];
+    return board.currentTurn == WHITE ? whiteScore : -whiteScore;
+}
+
+}
@@ -0,0 +1,56 @@
+#include "game.h"
+
+std::string GameStatusToString(GameStatus status) {
+    switch (status) {
+        case CHECKMATE: return "Checkmate";
+        case STALEMATE: return "Stalemate";
+        case DRAW_FIFTY_MOVES: return "Draw by the fifty-move rule";
+        case DRAW_THREEFOLD: return "Draw by threefold repetition";
+        case DRAW_INSUFFICIENT_MATERIAL: return "Draw by insufficient material";
+        default: return "Ongoing";
+    }
+}
+
+Game::Game() {
+    history.reserve(RESERVED_GAME_PLY);
+}
+
+void Game::LoadPositionFromFen(const std::string& fen) {
+    board.LoadPositionFromFen(fen);
+    history.clear();
+    keys.Clear();
+}
+
+void Game::MakeMove(Move move) {
+    keys.Push(board.key);
+    history.emplace_back();
+    board.MakeMove(move, history.back());
+}
+
+void Game::UnmakeMove() {
+    board.UnmakeMove(history.back());
+    history.pop_back();
+    keys.Pop();
+}
+
+// Everything the GUI needs to know after a move, for the price of a single
+// legal-move generation and one attack test on the king.
+GameStatus Game::Evaluate() const {
+    int kingPosition = board.FindKingPosition();
+    if (kingPosition == -1) return ONGOING;
+
+    MoveList moves;
+    board.GenerateLegalMoves(moves);
+    if (moves.Empty()) {
+        return board.IsKingInCheck(kingPosition) ? CHECKMATE : STALEMATE;
+    }
+
+    if (board.halfmoveClock >= 100) return DRAW_FIFTY_MOVES;
+    if (IsRepetition(3)) return DRAW_THREEFOLD;
+    if (board.HasInsufficientMaterial()) return DRAW_INSUFFICIENT_MATERIAL;
+    return ONGOING;
+}
+
+bool Game::IsRepetition(int times) const {
+    return keys.IsRepetition(board.key, board.halfmoveClock, times);
+}
@@ -7,42 +7,29 @@
 #include <algorithm>
 #include <vector>
 #include <cassert>
+#include <thread>
+#include "game.h"
+#include "search.h"
 
 bool isAtLatestState = true;
 const int WINDOW_WIDTH = 1280;
 const int WINDOW_HEIGHT = 640;
 const int BOARD_WIDTH = 640;
 const int BOARD_HEIGHT = 640;
-const int BOARD_SIZE = 8;
-const int TOTAL_SQUARES = BOARD_SIZE * BOARD_SIZE;
 int squareSize = BOARD_WIDTH / BOARD_SIZE;
 int boardX = (WINDOW_WIDTH - BOARD_WIDTH) / 2;
 int boardY = 0;
 
-class Piece {
-public:
-    std::vector<int> validMoves;
-    const int none = 0;
-    const int king = 1;
-    const int pawn = 2;
-    const int knight = 3;
-    const int bishop = 4;
-    const int rook = 5;
-    const int queen = 6;
-
-    const int white = 8;
-    const int black = 16;
-};
-
 class BoardStateList {
 private:
     struct Node {
-        std::string fen;  
         std::string san;  
+        // The move that led here, replayed by Redo; none for the first position.
+        Move move;
         Node* prev;       
         Node* next;       
 
-        Node(const std::string& state, const std::string& moveSan) : fen(state), prev(nullptr), next(nullptr), san(moveSan) {}
+        Node(const std::string& moveSan, Move lastMove) : san(moveSan), move(lastMove), prev(nullptr), next(nullptr) {}
     };
 
     Node* head;    
@@ -53,8 +40,8 @@ public:
     BoardStateList() : head(nullptr), tail(nullptr), current(nullptr){}
 
     
-    void AddState(const std::string& state, const std::string& san) {
-        Node* newNode = new Node(state, san);
+    void AddState(const std::string& san, Move move) {
+        Node* newNode = new Node(san, move);
 
         if (!head) {  
             head = tail = current = newNode;
@@ -80,36 +67,33 @@ public:
     }
 
     
-    bool Undo(std::string& state) {
+    // Undo and redo step the board with UnmakeMove / MakeMove rather than
+    // reloading a FEN, so clocks and the repetition history survive.
+    bool Undo(Game& game) {
         std::cout<<displayCurrentSan()<<std::endl;
-        isAtLatestState = false;
         if (current && current->prev) {
+            isAtLatestState = false;
+            game.UnmakeMove();
             current = current->prev;
-            state = current->fen;
             return true;
         }
         return false; 
     }
 
     
-    bool Redo(std::string& state) {
+    bool Redo(Game& game) {
         std::cout<<displayCurrentSan()<<std::endl;
-        if(tail->prev->fen == current->fen)
-            isAtLatestState = true;
         if (current && current->next) {
             current = current->next;
-            state = current->fen;
+            game.MakeMove(current->move);
+            if (current == tail)
+                isAtLatestState = true;
             return true;
         }
         return false; 
     }
 
     
-    std::string GetCurrentState() const {
-        return (current) ? current->fen : "";
-    }
-
-    
     void Clear() {
         Node* temp = head;
         while (temp) {
@@ -120,30 +104,33 @@ public:
         head = tail = current = nullptr;
     }
 
-    std::string getSAN(int piece, int startSquare, int endSquare, bool isCapture) {
-    Piece p;
+    std::string getSAN(PieceType piece, Move move, bool isCapture) {
     std::string san = "";
 
+    if (move.Flag() == CASTLING) {
+        return (move.To() > move.From()) ? "O-O" : "O-O-O";
+    }
+
     
-    if (piece == p.knight) san += "N";
-    else if (piece == p.bishop) san += "B";
-    else if (piece == p.rook) san += "R";
-    else if (piece == p.queen) san += "Q";
-    else if (piece == p.king) san += "K";
+    if (piece == KNIGHT) san += "N";
+    else if (piece == BISHOP) san += "B";
+    else if (piece == ROOK) san += "R";
+    else if (piece == QUEEN) san += "Q";
+    else if (piece == KING) san += "K";
 
     
-    if (piece == p.pawn && isCapture) {
-        san += squareToAlgebraic(startSquare)[0];
+    if (piece == PAWN && isCapture) {
+        san += SquareToString(move.From())[0];
     }
 
     if (isCapture) san += "x"; 
 
     
-    san += squareToAlgebraic(endSquare);
+    san += SquareToString(move.To());
 
-    
-    if (piece == p.king && abs(startSquare - endSquare) == 2) {
-        return (endSquare > startSquare) ? "O-O" : "O-O-O";
+    if (move.Promotion()) {
+        san += '=';
+        san += " KPNBRQ"[move.Promotion()];
     }
 
     return san;
@@ -153,14 +140,6 @@ public:
         return "Current Move: "+current->san;
     }
 
-    std::string squareToAlgebraic(int squareIndex) {
-        int row = squareIndex / 8;
-        int col = squareIndex % 8;
-        char file = 'a' + col;
-        char rank = '1' + row;
-        return std::string(1, file) + rank;
-    }
-    
     void displayMoveHistory() {
         Node* temp = head;
         int moveNumber = 1;
@@ -180,334 +159,6 @@ public:
     }
 };
 
-class Board {
-public:
-    int squares[64];
-    Piece p;
-    int currentTurn;
-
-    Board() {
-        currentTurn = p.white; 
-        const std::string startFen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
-        LoadPositionFromFen(startFen);
-    }
-
-    void LoadPositionFromFen(const std::string& fen) {
-        std::unordered_map<char, int> pieceTypeFromSymbol = {
-            {'k', p.king},   {'p', p.pawn}, {'n', p.knight},
-            {'b', p.bishop}, {'r', p.rook}, {'q', p.queen}
-        };
-
-        std::string fenBoard = fen.substr(0, fen.find(' '));
-        int column = 0, row = 0;
-
-        for (int i = 0; i < 64; i++) {
-            squares[i] = p.none;
-        }
-
-        for (char symbol : fenBoard) {
-            if (symbol == '/') {
-                column = 0;
-                row++;
-            } else {
-                if (isdigit(symbol)) {
-                    column += symbol - '0';
-                } else {
-                    int pieceColour = isupper(symbol) ? p.white : p.black;
-                    int pieceType = pieceTypeFromSymbol[tolower(symbol)];
-                    squares[row * BOARD_SIZE + column] = pieceType | pieceColour;
-                    column++;
-                }
-            }
-        }
-    }
-
-    std::string GetFenFromPosition() {
-    std::string fen = "";
-    int emptyCount = 0;
-
-    for (int row = 0; row < BOARD_SIZE; ++row) {
-        for (int col = 0; col < BOARD_SIZE; ++col) {
-            int square = squares[row * BOARD_SIZE + col];
-            if (square == p.none) {
-                emptyCount++;
-            } else {
-                if (emptyCount > 0) {
-                    fen += std::to_string(emptyCount);
-                    emptyCount = 0;
-                }
-
-                char pieceChar = ' ';
-                int pieceType = square & 7;
-                int pieceColor = square & (p.white | p.black);
-
-                if (pieceType == p.king)       pieceChar = 'k';
-                else if (pieceType == p.queen) pieceChar = 'q';
-                else if (pieceType == p.rook)  pieceChar = 'r';
-                else if (pieceType == p.bishop) pieceChar = 'b';
-                else if (pieceType == p.knight) pieceChar = 'n';
-                else if (pieceType == p.pawn)  pieceChar = 'p';
-
-                if (pieceColor == p.white) pieceChar = toupper(pieceChar);
-                fen += pieceChar;
-            }
-        }
-
-        if (emptyCount > 0) {
-            fen += std::to_string(emptyCount);
-            emptyCount = 0;
-        }
-
-        if (row != BOARD_SIZE - 1) fen += '/';
-    }
-
-    
-    fen += " w - - 0 1"; 
-
-    return fen;
-}
-
-void SwitchTurn() {
-        currentTurn = (currentTurn == p.white) ? p.black : p.white;
-    }
-
-bool IsValidMove(int piece, int from, int to) {
-    if (from == to) return false; 
-
-    int fromRow = from / BOARD_SIZE;
-    int fromCol = from % BOARD_SIZE;
-    int toRow = to / BOARD_SIZE;
-    int toCol = to % BOARD_SIZE;
-
-    int deltaRow = toRow - fromRow;
-    int deltaCol = toCol - fromCol;
-
-    int pieceType = piece & 7;
-    int pieceColor = piece & (p.white | p.black);
-
-    if ((squares[to] & 7) == p.king){
-        return false;
-    }
-    
-    if (squares[to] != p.none && (squares[to] & (p.white | p.black)) == pieceColor) {
-        return false;
-    }
-
-    if (pieceType == p.king) {
-    int opponentColor = (pieceColor == p.white) ? p.black : p.white;
-    
-    for (int i = 0; i < 64; ++i) {
-        if ((squares[i] & (p.white | p.black)) == opponentColor) {
-            if (IsValidMove(squares[i], i, to)) {
-                return false;
-            }
-        }
-    }
-}
-
-    switch (pieceType) {
-        case 2: 
-            if (pieceColor == p.white) {
-                if (deltaRow == -1 && deltaCol == 0 && squares[to] == p.none) return true;
-                if (fromRow == 6 && deltaRow == -2 && deltaCol == 0 && squares[to] == p.none) return true; 
-                if (deltaRow == -1 && abs(deltaCol) == 1 && squares[to] & p.black) return true; 
-                
-                if (deltaRow == -1 && abs(deltaCol) == 1 && squares[to] == p.none) {
-                    int capturedPawn = (to + BOARD_SIZE) % 64;
-                    if ((squares[capturedPawn] & 7) == 2 && (squares[capturedPawn] & (p.white | p.black)) == p.black) {
-                        return true;
-                    }
-                }
-            } else { 
-                if (deltaRow == 1 && deltaCol == 0 && squares[to] == p.none) return true; 
-                if (fromRow == 1 && deltaRow == 2 && deltaCol == 0 && squares[to] == p.none) return true; 
-                if (deltaRow == 1 && abs(deltaCol) == 1 && squares[to] & p.white) return true; 
-                
-                if (deltaRow == 1 && abs(deltaCol) == 1 && squares[to] == p.none) {
-                    int capturedPawn = (to - BOARD_SIZE) % 64;
-                    if ((squares[capturedPawn] & 7) == 2 && (squares[capturedPawn] & (p.white | p.black)) == p.white) {
-                        return true;
-                    }
-                }
-            }
-            return false;
-
-        case 3: 
-            return (abs(deltaRow) == 2 && abs(deltaCol) == 1) || (abs(deltaRow) == 1 && abs(deltaCol) == 2);
-
-        case 4: 
-            if (abs(deltaRow) == abs(deltaCol)) {
-                return IsPathClear(fromRow, fromCol, toRow, toCol);
-            }
-            return false;
-
-        case 5: 
-            if (deltaRow == 0 || deltaCol == 0) {
-                return IsPathClear(fromRow, fromCol, toRow, toCol);
-            }
-            return false;
-
-        case 6: 
-            if (deltaRow == 0 || deltaCol == 0 || abs(deltaRow) == abs(deltaCol)) {
-                return IsPathClear(fromRow, fromCol, toRow, toCol);
-            }
-            return false;
-
-        case 1: 
-            if (abs(deltaRow) <= 1 && abs(deltaCol) <= 1) return true; 
-            
-            if (deltaRow == 0 && abs(deltaCol) == 2) {
-                int rookFrom = (deltaCol > 0) ? from + 3 : from - 4;
-                int rookTo = (deltaCol > 0) ? from + 1 : from - 1;
-                if ((squares[rookFrom] & 7) == 5 && IsPathClear(fromRow, fromCol, toRow, rookTo)) {
-                    
-                    for (int col = fromCol; col != toCol; col += (deltaCol > 0 ? 1 : -1)) {
-                        if (IsKingInCheck(fromRow * BOARD_SIZE + col)) {
-                            return false;
-                        }
-                    }
-                    return true;
-                }
-            }
-            return false;
-
-        default:
-            return false;
-    }
-}
-
-bool IsPathClear(int fromRow, int fromCol, int toRow, int toCol) {
-    int deltaRow = (toRow > fromRow) ? 1 : (toRow < fromRow) ? -1 : 0;
-    int deltaCol = (toCol > fromCol) ? 1 : (toCol < fromCol) ? -1 : 0;
-
-    int currentRow = fromRow + deltaRow;
-    int currentCol = fromCol + deltaCol;
-
-    while (currentRow != toRow || currentCol != toCol) {
-        if (squares[currentRow * BOARD_SIZE + currentCol] != p.none) {
-            return false; 
-        }
-        currentRow += deltaRow;
-        currentCol += deltaCol;
-    }
-    return true;
-}
-
-bool IsKingInCheck(int kingPosition) {
-    int opponentColor = (currentTurn == p.white) ? p.black : p.white;
-
-    for (int i = 0; i < 64; ++i) {
-        int piece = squares[i];
-        if ((piece & (p.white | p.black)) == opponentColor) {
-            if (IsValidMove(piece, i, kingPosition)) {
-                return true; 
-            }
-        }
-    }
-    return false;
-}
-
-bool NeedsPromotion(int piece, int squareIndex, int boardSize, int currentTurn) {
-    
-    const int pawnType = 2;
-    Piece p;
-    if ((piece & 7) != pawnType) {
-        return false;
-    }
-
-    
-    int row = squareIndex / boardSize;
-    if ((currentTurn == p.white && row == 0) || (currentTurn == p.black && row == boardSize - 1)) {
-        return true;
-    }
-
-    return false;
-}
-
-int FindKingPosition() {
-    int kingType = p.king | currentTurn;
-    for (int i = 0; i < 64; ++i) {
-        if (squares[i] == kingType) {
-            return i;
-        }
-    }
-    return -1; 
-}
-
-bool IsCheckmate() {
-    int kingPosition = FindKingPosition();
-    if (kingPosition == -1) {
-        std::cerr << "Error: King not found on the board." << std::endl;
-        return false;
-    }
-
-    if (!IsKingInCheck(kingPosition)) {
-        
-        return false;
-    }
-
-    for (int from = 0; from < 64; ++from) {
-        int piece = squares[from];
-        if ((piece & (p.white | p.black)) == currentTurn) {
-            for (int to = 0; to < 64; ++to) {
-                if (IsValidMove(piece, from, to)) {
-                    
-                    int savedPiece = squares[to];
-                    squares[to] = piece;
-                    squares[from] = p.none;
-
-                    
-                    int newKingPosition = (piece & 7) == p.king ? to : kingPosition;
-                    bool stillInCheck = IsKingInCheck(newKingPosition);
-
-                    
-                    squares[from] = piece;
-                    squares[to] = savedPiece;
-
-                    if (!stillInCheck) {
-                        std::cout << "Found a valid move from " << from << " to " << to << ". Not checkmate." << std::endl;
-                        return false;
-                    }
-                }
-            }
-        }
-    }
-
-    std::cout << "No valid moves found. Checkmate!" << std::endl;
-    return true;
-}
-
-bool IsStalemate() {
-    
-    int kingPosition = FindKingPosition();
-    if (kingPosition == -1) {
-        std::cerr << "Error: King not found on the board." << std::endl;
-        return false;
-    }
-
-    
-    if (IsKingInCheck(kingPosition)) {
-        return false;
-    }
-
-    
-    for (int from = 0; from < 64; ++from) {
-        int piece = squares[from];
-        if ((piece & (p.white | p.black)) == currentTurn) {
-
-            
-            for (int to = 0; to < 64; ++to) {
-                if (IsValidMove(piece, from, to)) {
-                    return false; 
-                }
-            }
-        }
-    }
-
-    
-    return true;
-}
-
 int getSquareIndex(int x, int y, int squareSize) {
     x -= boardX;
     y -= boardY;
@@ -521,8 +172,6 @@ int getSquareIndex(int x, int y, int squareSize) {
     return row * BOARD_SIZE + col;
 }
 
-};
-
 
 void RunCheckmateTests(Board& board) {
     struct TestCase {
@@ -558,7 +207,7 @@ void RunCheckmateTests(Board& board) {
     }
 }
 
-void drawChessboard(SDL_Renderer* renderer, const std::vector<int>& validMoves, int pickedSquare = -1) {
+void drawChessboard(SDL_Renderer* renderer, Bitboard highlightedSquares, int pickedSquare = -1) {
     
     SDL_Color lightSquareColor = {240, 217, 181, 255}; 
     SDL_Color darkSquareColor = {181, 136, 99, 255};  
@@ -577,7 +226,7 @@ void drawChessboard(SDL_Renderer* renderer, const std::vector<int>& validMoves,
                 SDL_SetRenderDrawColor(renderer, pickedSquareColor.r, pickedSquareColor.g, pickedSquareColor.b, pickedSquareColor.a);
             }
             
-            else if (std::find(validMoves.begin(), validMoves.end(), squareIndex) != validMoves.end()) {
+            else if (highlightedSquares & SquareBB(squareIndex)) {
                 SDL_Color highlightColor = (row + col) % 2 == 0 ? highlightLight : highlightDark;
                 SDL_SetRenderDrawColor(renderer, highlightColor.r, highlightColor.g, highlightColor.b, highlightColor.a);
             }
@@ -604,10 +253,10 @@ void drawChessboard(SDL_Renderer* renderer, const std::vector<int>& validMoves,
 }
 
 
-void drawPieces(SDL_Renderer* renderer, Board& board, std::unordered_map<int, SDL_Texture*>& textures) {
+void drawPieces(SDL_Renderer* renderer, Board& board, std::unordered_map<int, SDL_Texture*>& textures, int hiddenSquare = -1) {
     for (int i = 0; i < 64; ++i) {
-        int piece = board.squares[i];
-        if (piece == 0) continue; 
+        Piece piece = board.PieceOn(i);
+        if (piece == NO_PIECE || i == hiddenSquare) continue; 
 
         int row = i / BOARD_SIZE;
         int col = i % BOARD_SIZE;
@@ -624,12 +273,11 @@ void drawPieces(SDL_Renderer* renderer, Board& board, std::unordered_map<int, SD
     }
 }
 
-int showPromotionDialog(SDL_Renderer* renderer, std::unordered_map<int, SDL_Texture*>& textures, int currentTurn) {
+PieceType showPromotionDialog(SDL_Renderer* renderer, std::unordered_map<int, SDL_Texture*>& textures, Colour currentTurn) {
     const int dialogWidth = 200;
     const int dialogHeight = 100;
     const int dialogX = (WINDOW_WIDTH - dialogWidth) / 2;
     const int dialogY = (WINDOW_HEIGHT - dialogHeight) / 2;
-    Piece p;
 
     
     SDL_Rect dialogRect = {dialogX, dialogY, dialogWidth, dialogHeight};
@@ -637,11 +285,11 @@ int showPromotionDialog(SDL_Renderer* renderer, std::unordered_map<int, SDL_Text
     SDL_RenderFillRect(renderer, &dialogRect);
 
     
-    int pieceTypes[] = {p.queen, p.rook, p.bishop, p.knight};
+    PieceType pieceTypes[] = {QUEEN, ROOK, BISHOP, KNIGHT};
     SDL_Rect pieceRects[4];
     for (int i = 0; i < 4; ++i) {
         pieceRects[i] = {dialogX + i * 50, dialogY + 25, 50, 50}; 
-        int piece = pieceTypes[i] | currentTurn; 
+        Piece piece = MakePiece(currentTurn, pieceTypes[i]); 
         SDL_RenderCopy(renderer, textures[piece], nullptr, &pieceRects[i]);
     }
     SDL_RenderPresent(renderer);
@@ -651,7 +299,7 @@ int showPromotionDialog(SDL_Renderer* renderer, std::unordered_map<int, SDL_Text
     while (true) {
         while (SDL_PollEvent(&event)) {
             if (event.type == SDL_QUIT) {
-                return -1; 
+                return NO_PIECE_TYPE; 
             } else if (event.type == SDL_MOUSEBUTTONDOWN) {
                 int mouseX = event.button.x;
                 int mouseY = event.button.y;
@@ -693,6 +341,17 @@ void renderText(SDL_Renderer* renderer, TTF_Font* font, const char* text, int x,
 
 
 int main(int argc, char* argv[]) {
+    SliderBackend slider = SLIDER_AUTO;
+    for (int i = 1; i + 1 < argc; i++) {
+        if (std::string(argv[i]) == "--slider" && !Bitboards::ParseSliderBackend(argv[i + 1], slider)) {
+            std::cerr << "Unknown slider backend " << argv[i + 1] << ", using auto" << std::endl;
+        }
+    }
+    Bitboards::Init(slider);
+    Zobrist::Init();
+    std::cout << "Attack tables: " << Bitboards::TableBytes() / 1024 << " KB built in "
+              << Bitboards::InitMicroseconds << " us, " << Bitboards::SliderBackendName() << " sliders" << std::endl;
+
     bool isDragging = false;
     int draggedPiece = 0;
     int draggedFromSquare = -1;
@@ -745,23 +404,22 @@ int main(int argc, char* argv[]) {
     }
 
 
-    Piece p;
     BoardStateList state;
     std::unordered_map<int, SDL_Texture*> textures;
     
-    textures[p.white | p.king] = IMG_LoadTexture(renderer, "res/Pieces/w_king_2x.png");
-    textures[p.white | p.queen] = IMG_LoadTexture(renderer, "res/Pieces/w_queen_2x.png");
-    textures[p.white | p.rook] = IMG_LoadTexture(renderer, "res/Pieces/w_rook_2x.png");
-    textures[p.white | p.bishop] = IMG_LoadTexture(renderer, "res/Pieces/w_bishop_2x.png");
-    textures[p.white | p.knight] = IMG_LoadTexture(renderer, "res/Pieces/w_knight_2x.png");
-    textures[p.white | p.pawn] = IMG_LoadTexture(renderer, "res/Pieces/w_pawn_2x.png");
-
-    textures[p.black | p.king] = IMG_LoadTexture(renderer, "res/Pieces/b_king_2x.png");
-    textures[p.black | p.queen] = IMG_LoadTexture(renderer, "res/Pieces/b_queen_2x.png");
-    textures[p.black | p.rook] = IMG_LoadTexture(renderer, "res/Pieces/b_rook_2x.png");
-    textures[p.black | p.bishop] = IMG_LoadTexture(renderer, "res/Pieces/b_bishop_2x.png");
-    textures[p.black | p.knight] = IMG_LoadTexture(renderer, "res/Pieces/b_knight_2x.png");
-    textures[p.black | p.pawn] = IMG_LoadTexture(renderer, "res/Pieces/b_pawn_2x.png");
+    textures[W_KING] = IMG_LoadTexture(renderer, "res/Pieces/w_king_2x.png");
+    textures[W_QUEEN] = IMG_LoadTexture(renderer, "res/Pieces/w_queen_2x.png");
+    textures[W_ROOK] = IMG_LoadTexture(renderer, "res/Pieces/w_rook_2x.png");
+    textures[W_BISHOP] = IMG_LoadTexture(renderer, "res/Pieces/w_bishop_2x.png");
+    textures[W_KNIGHT] = IMG_LoadTexture(renderer, "res/Pieces/w_knight_2x.png");
+    textures[W_PAWN] = IMG_LoadTexture(renderer, "res/Pieces/w_pawn_2x.png");
+
+    textures[B_KING] = IMG_LoadTexture(renderer, "res/Pieces/b_king_2x.png");
+    textures[B_QUEEN] = IMG_LoadTexture(renderer, "res/Pieces/b_queen_2x.png");
+    textures[B_ROOK] = IMG_LoadTexture(renderer, "res/Pieces/b_rook_2x.png");
+    textures[B_BISHOP] = IMG_LoadTexture(renderer, "res/Pieces/b_bishop_2x.png");
+    textures[B_KNIGHT] = IMG_LoadTexture(renderer, "res/Pieces/b_knight_2x.png");
+    textures[B_PAWN] = IMG_LoadTexture(renderer, "res/Pieces/b_pawn_2x.png");
 
     for (auto& [key, texture] : textures) {
         if (!texture) {
@@ -769,14 +427,35 @@ int main(int argc, char* argv[]) {
         }
     }
 
-    Board board;
-    state.AddState(board.GetFenFromPosition(), state.getSAN(0,0,0,0));
+    Game game;
+    Board& board = game.board;
+    MoveList legalMoves;
+    state.AddState("", Move());
 
     bool running = true;
     SDL_Event event;
+
+    // Shared by a dropped piece and an engine move.
+    auto playMove = [&](Move move) {
+        PieceType movedPiece = TypeOf(board.PieceOn(move.From()));
+        bool isCapture = board.PieceOn(move.To()) != NO_PIECE || move.Flag() == EN_PASSANT;
+        game.MakeMove(move);
+        state.AddState(state.getSAN(movedPiece, move, isCapture), move);  
+
+        GameStatus status = game.Evaluate();
+        if (status == CHECKMATE) {
+            std::string winner = (board.currentTurn == WHITE) ? "Black" : "White";
+            std::cout << "Checkmate! " << winner << " wins!" << std::endl;
+            running = false; 
+        } else if (status != ONGOING) {
+            std::cout << GameStatusToString(status) << "!" << std::endl;
+            running = false;
+        }
+    };
+    TranspositionTable tt(64);
+    SearchPool searchPool(tt, std::max(1u, std::thread::hardware_concurrency()));
     int squareSize = BOARD_WIDTH / BOARD_SIZE;
-    int startSquare = -1; 
-    int endSquare = -1;   
+    Bitboard highlightedSquares = 0;
 
     while (running) {
         while (SDL_PollEvent(&event)) {
@@ -786,21 +465,21 @@ int main(int argc, char* argv[]) {
                     break;
                 case SDL_MOUSEBUTTONDOWN:
                     if (event.button.button == SDL_BUTTON_LEFT) {
-                        int squareIndex = startSquare = board.getSquareIndex(event.button.x, event.button.y, squareSize);
-                        int piece = board.squares[squareIndex];
-                            if (piece != board.p.none && (piece & (board.p.white | board.p.black)) == board.currentTurn && isAtLatestState) {
+                        int squareIndex = getSquareIndex(event.button.x, event.button.y, squareSize);
+                        Piece piece = squareIndex != -1 ? board.PieceOn(squareIndex) : NO_PIECE;
+                            if (piece != NO_PIECE && ColourOf(piece) == board.currentTurn && isAtLatestState) {
                             isDragging = true;
                             draggedFromSquare = squareIndex;
-                            draggedPiece = board.squares[squareIndex];
-                            board.squares[squareIndex] = board.p.none;
+                            draggedPiece = piece;
                             mouseX = event.button.x;
                             mouseY = event.button.y;
 
                             
-                            p.validMoves.clear();
-                            for (int target = 0; target < 64; ++target) {
-                                if (board.IsValidMove(draggedPiece, squareIndex, target)) {
-                                    p.validMoves.push_back(target);
+                            highlightedSquares = 0;
+                            board.GenerateLegalMoves(legalMoves);
+                            for (Move move : legalMoves) {
+                                if (move.From() == squareIndex) {
+                                    highlightedSquares |= SquareBB(move.To());
                                 }
                             }
                         }                        
@@ -808,34 +487,26 @@ int main(int argc, char* argv[]) {
                     break;
                 case SDL_MOUSEBUTTONUP:
                     if (event.button.button == SDL_BUTTON_LEFT && isDragging) {
-                        int squareIndex = endSquare = board.getSquareIndex(event.button.x, event.button.y, squareSize);
-                        bool isCapture = false;
-                        if (board.IsValidMove(draggedPiece, draggedFromSquare, squareIndex)) {
-                            board.squares[squareIndex] = draggedPiece;
-                            bool isCapture = false;
-                            int movedPiece = board.squares[squareIndex]; 
-                            if (board.IsCheckmate()) {
-                                std::string winner = (board.currentTurn == board.p.white) ? "Black" : "White";
-                                std::cout << "Checkmate! " << winner << " wins!" << std::endl;
-                                running = false; 
+                        int squareIndex = getSquareIndex(event.button.x, event.button.y, squareSize);
+                        Move chosenMove;
+                        for (Move move : legalMoves) {
+                            if (move.From() == draggedFromSquare && move.To() == squareIndex) {
+                                chosenMove = move;
+                                break;
                             }
-
-                            if (board.NeedsPromotion(movedPiece, squareIndex, BOARD_SIZE, board.currentTurn)) {
+                        }
+                        if (!chosenMove.IsNone()) {
+                            if (chosenMove.Promotion()) {
                                 std::cout << "Pawn needs promotion!" << std::endl;
-                                int promotedPiece = showPromotionDialog(renderer, textures, board.currentTurn);
-                                if (promotedPiece > 0) {
-                                    board.squares[squareIndex] = promotedPiece | board.currentTurn; 
-                                }
+                                PieceType promotedPiece = showPromotionDialog(renderer, textures, board.currentTurn);
+                                chosenMove = Move::Make(draggedFromSquare, squareIndex, PROMOTION, promotedPiece != NO_PIECE_TYPE ? promotedPiece : QUEEN);
                             }
-                            state.AddState(board.GetFenFromPosition(),state.getSAN(squareIndex,startSquare,endSquare,isCapture));  
-                            board.SwitchTurn();
-                        } else {
-                            board.squares[draggedFromSquare] = draggedPiece;
+                            playMove(chosenMove);
                         }
                         isDragging = false;
                         draggedFromSquare = -1;
                     }
-                    p.validMoves.clear();
+                    highlightedSquares = 0;
                     break;
                 case SDL_MOUSEMOTION:
                     if (isDragging) {
@@ -846,26 +517,31 @@ int main(int argc, char* argv[]) {
                 case SDL_KEYDOWN:
                     if (event.key.keysym.sym == SDLK_l) { 
                         std::string customFen = "6k1/5ppp/8/8/8/5Q2/6PP/6K1 w - - 0 1";
-                        board.LoadPositionFromFen(customFen);
+                        game.LoadPositionFromFen(customFen);
+                        searchPool.Clear();
+                        state.Clear();
+                        state.AddState("", Move());
+                        isAtLatestState = true;
                         std::cout << "Loaded FEN: " << customFen << std::endl;
                     }
-                    std::string previousState;
                     if (event.key.keysym.sym == SDLK_u) {  
-                        std::string previousState;
-                        if (state.Undo(previousState)) {
-                            board.LoadPositionFromFen(previousState);
-                        } else {
+                        if (!state.Undo(game)) {
                             std::cout << "Nothing to undo!" << std::endl;
                         }
                     }
                     if (event.key.keysym.sym == SDLK_r) {  
-                        std::string nextState;
-                        if (state.Redo(nextState)) {
-                            board.LoadPositionFromFen(nextState);
-                        } else {
+                        if (!state.Redo(game)) {
                             std::cout << "Nothing to redo!" << std::endl;
                         }
                     }
+                    if (event.key.keysym.sym == SDLK_e && isAtLatestState && !isDragging) {
+                        SearchLimits limits;
+                        limits.milliseconds = 1000;
+                        SearchResult result = searchPool.Search(board, game.Keys(), limits, &std::cout);
+                        if (!result.bestMove.IsNone()) {
+                            playMove(result.bestMove);
+                        }
+                    }
                     break;
             }
         }
@@ -873,18 +549,19 @@ int main(int argc, char* argv[]) {
         SDL_SetRenderDrawColor(renderer, 48, 46, 43, 255);
         SDL_RenderClear(renderer);
 
-        drawChessboard(renderer, p.validMoves, draggedFromSquare);
-        drawPieces(renderer, board, textures);
+        drawChessboard(renderer, highlightedSquares, draggedFromSquare);
+        drawPieces(renderer, board, textures, draggedFromSquare);
 
         bool isWhiteTurn = true; 
 
         
         SDL_Color textColor = {255, 255, 255, 255}; 
-        const char* turnText = (board.currentTurn == p.white) ? "White's Turn" : "Black's Turn";
+        const char* turnText = (board.currentTurn == WHITE) ? "White's Turn" : "Black's Turn";
         const char * currentMove = state.displayCurrentSan().c_str();
         renderText(renderer, font, turnText, 50, 100, textColor,5); 
         renderText(renderer, font, "(U) for Undo", 50, 200, textColor,0);
         renderText(renderer, font, "(R) for Redo", 50, 250, textColor,0);
+        renderText(renderer, font, "(E) for Engine move", 50, 300, textColor,0);
         if(!isAtLatestState)
         {
             renderText(renderer, font, "Redo All the moves to", boardX+BOARD_WIDTH+25, 100, {255, 255, 255, 255},0);
@@ -0,0 +1,135 @@
+#include "movepicker.h"
+#include "evaluate.h"
+
+namespace {
+
+// Indexed by PieceType. Captures are scored by the victim's Eval::PieceValue,
+// which dominates, so every capture of a queen comes before every capture of a
+// rook, and among those the cheapest attacker goes first.
+const int attackerRank[7] = {0, 6, 1, 2, 3, 4, 5};
+
+}
+
+MovePicker::MovePicker(const Board& board, Move hashMove, Move killer1, Move killer2, Move counterMove,
+                       const MoveHistory* history, const PieceToHistory* continuation1,
+                       const PieceToHistory* continuation2)
+    : board(board), hashMove(hashMove), counterMove(counterMove), history(history), stage(HASH_MOVE),
+      capturesOnly(false), index(0), badIndex(0) {
+    killers[0] = killer1;
+    killers[1] = killer2;
+    continuation[0] = continuation1;
+    continuation[1] = continuation2;
+}
+
+MovePicker::MovePicker(const Board& board)
+    : board(board), history(nullptr), stage(GENERATE_CAPTURES), capturesOnly(true), index(0), badIndex(0) {
+    continuation[0] = continuation[1] = nullptr;
+}
+
+Move MovePicker::Next() {
+    switch (stage) {
+        case HASH_MOVE:
+            stage = GENERATE_CAPTURES;
+            if (board.IsLegal(hashMove)) return hashMove;
+            // fall through
+
+        case GENERATE_CAPTURES:
+            board.GenerateCaptures(moves);
+            for (int i = 0; i < moves.Size(); ++i) {
+                Move move = moves[i];
+                PieceType victim = move.Flag() == EN_PASSANT ? PAWN : TypeOf(board.PieceOn(move.To()));
+                scores[i] = Eval::PieceValue[victim] * 8 + Eval::PieceValue[move.Promotion()] * 8
+                          - attackerRank[TypeOf(board.PieceOn(move.From()))];
+            }
+            index = 0;
+            stage = GOOD_CAPTURES;
+            // fall through
+
+        case GOOD_CAPTURES:
+            while (index < moves.Size()) {
+                Move move = PickBest();
+                if (move == hashMove) continue;
+                if (board.SeeGe(move, 0)) return move;
+                badCaptures.Add(move);
+            }
+            if (capturesOnly) {
+                stage = DONE;
+                return Move();
+            }
+            stage = FIRST_KILLER;
+            // fall through
+
+        case FIRST_KILLER:
+            stage = SECOND_KILLER;
+            if (!IsSpecial(killers[0]) && board.IsLegal(killers[0])) return killers[0];
+            // fall through
+
+        case SECOND_KILLER:
+            stage = COUNTERMOVE;
+            if (killers[1] != killers[0] && !IsSpecial(killers[1]) && board.IsLegal(killers[1])) return killers[1];
+            // fall through
+
+        case COUNTERMOVE:
+            stage = GENERATE_QUIETS;
+            if (counterMove != killers[0] && counterMove != killers[1] && !IsSpecial(counterMove)
+                && board.IsLegal(counterMove)) {
+                return counterMove;
+            }
+            // fall through
+
+        case GENERATE_QUIETS:
+            board.GenerateQuiets(moves);
+            for (int i = 0; i < moves.Size(); ++i) {
+                Move move = moves[i];
+                Piece piece = board.PieceOn(move.From());
+                int score = 0;
+                if (history) score += history->butterfly[board.currentTurn][move.From()][move.To()];
+                if (continuation[0]) score += (*continuation[0])[piece][move.To()];
+                if (continuation[1]) score += (*continuation[1])[piece][move.To()];
+                scores[i] = score;
+            }
+            index = 0;
+            stage = QUIETS;
+            // fall through
+
+        case QUIETS:
+            while (index < moves.Size()) {
+                Move move = history ? PickBest() : moves[index++];
+                if (move != hashMove && move != killers[0] && move != killers[1] && move != counterMove) return move;
+            }
+            stage = BAD_CAPTURES;
+            // fall through
+
+        case BAD_CAPTURES:
+            if (badIndex < badCaptures.Size()) return badCaptures[badIndex++];
+            stage = DONE;
+            // fall through
+
+        default:
+            return Move();
+    }
+}
+
+// Selection sort one step at a time: cheaper than sorting the whole list when
+// the node cuts off after the first few moves.
+Move MovePicker::PickBest() {
+    int best = index;
+    for (int i = index + 1; i < moves.Size(); ++i) {
+        if (scores[i] > scores[best]) best = i;
+    }
+
+    Move move = moves[best];
+    int score = scores[best];
+    moves.Set(best, moves[index]);
+    scores[best] = scores[index];
+    moves.Set(index, move);
+    scores[index] = score;
+    index++;
+    return move;
+}
+
+// Killers are quiet moves, and one that turns into a capture here was already
+// returned by the capture stage.
+bool MovePicker::IsSpecial(Move move) const {
+    return move.IsNone() || move == hashMove || board.IsCapture(move);
+}
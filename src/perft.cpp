@@ -0,0 +1,151 @@
+#include "perft.h"
+#include <thread>
+
+uint64_t Perft(Board& board, int depth) {
+    MoveList moves;
+    board.GenerateLegalMoves(moves);
+
+    // Bulk counting: the last ply only needs the size of the move list.
+    if (depth <= 1) {
+        return depth == 1 ? moves.Size() : 1;
+    }
+
+    uint64_t nodes = 0;
+    for (const Move& move : moves) {
+        UndoInfo undo;
+        board.MakeMove(move, undo);
+        nodes += Perft(board, depth - 1);
+        board.UnmakeMove(undo);
+    }
+    return nodes;
+}
+
+uint64_t PerftDivide(Board& board, int depth, std::ostream& out) {
+    MoveList moves;
+    board.GenerateLegalMoves(moves);
+
+    uint64_t total = 0;
+    for (const Move& move : moves) {
+        UndoInfo undo;
+        board.MakeMove(move, undo);
+        uint64_t nodes = Perft(board, depth - 1);
+        board.UnmakeMove(undo);
+
+        out << MoveToString(move) << ": " << nodes << std::endl;
+        total += nodes;
+    }
+    return total;
+}
+
+PerftHash::PerftHash(size_t megabytes) {
+    size_t count = 1;
+    while (count * 2 * sizeof(Entry) <= megabytes * 1024 * 1024) {
+        count *= 2;
+    }
+
+    entries.reset(new Entry[count]);
+    for (size_t i = 0; i < count; ++i) {
+        entries[i].check.store(0, std::memory_order_relaxed);
+        entries[i].data.store(0, std::memory_order_relaxed);
+    }
+    mask = count - 1;
+}
+
+// Data word: node count in the upper 56 bits, depth in the low 8.
+bool PerftHash::Probe(Key key, int depth, uint64_t& nodes) const {
+    const Entry& entry = entries[key & mask];
+    uint64_t data = entry.data.load(std::memory_order_relaxed);
+    uint64_t check = entry.check.load(std::memory_order_relaxed);
+
+    if ((check ^ data) != key || int(data & 0xFF) != depth) {
+        return false;
+    }
+    nodes = data >> 8;
+    return true;
+}
+
+void PerftHash::Store(Key key, int depth, uint64_t nodes) {
+    Entry& entry = entries[key & mask];
+    uint64_t data = (nodes << 8) | uint64_t(depth);
+    entry.check.store(key ^ data, std::memory_order_relaxed);
+    entry.data.store(data, std::memory_order_relaxed);
+}
+
+namespace {
+
+uint64_t HashedPerft(Board& board, int depth, PerftHash& hash, PerftStats& stats) {
+    MoveList moves;
+    board.GenerateLegalMoves(moves);
+
+    if (depth <= 1) {
+        return depth == 1 ? moves.Size() : 1;
+    }
+
+    uint64_t nodes = 0;
+    stats.probes++;
+    if (hash.Probe(board.key, depth, nodes)) {
+        stats.hits++;
+        return nodes;
+    }
+
+    for (const Move& move : moves) {
+        UndoInfo undo;
+        board.MakeMove(move, undo);
+        nodes += HashedPerft(board, depth - 1, hash, stats);
+        board.UnmakeMove(undo);
+    }
+
+    hash.Store(board.key, depth, nodes);
+    return nodes;
+}
+
+}
+
+uint64_t ParallelPerft(const Board& board, int depth, int threads, PerftHash* hash,
+                       std::vector<PerftStats>& threadStats, std::ostream* out) {
+    Board root(board);
+    MoveList moves;
+    root.GenerateLegalMoves(moves);
+
+    if (depth <= 1 || moves.Empty()) {
+        threadStats.assign(1, PerftStats());
+        threadStats[0].nodes = depth == 1 ? moves.Size() : 1;
+        return threadStats[0].nodes;
+    }
+
+    // Root moves are handed out one at a time, so a thread that drew a small
+    // subtree simply picks up the next move.
+    std::vector<uint64_t> subtreeNodes(moves.Size(), 0);
+    std::atomic<int> nextMove(0);
+    threadStats.assign(threads, PerftStats());
+
+    auto worker = [&](int id) {
+        Board local(board);
+        PerftStats& stats = threadStats[id];
+        for (int i = nextMove++; i < moves.Size(); i = nextMove++) {
+            UndoInfo undo;
+            local.MakeMove(moves[i], undo);
+            uint64_t nodes = hash ? HashedPerft(local, depth - 1, *hash, stats) : Perft(local, depth - 1);
+            local.UnmakeMove(undo);
+
+            subtreeNodes[i] = nodes;
+            stats.nodes += nodes;
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int id = 1; id < threads; ++id) {
+        pool.emplace_back(worker, id);
+    }
+    worker(0);
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+
+    uint64_t total = 0;
+    for (int i = 0; i < moves.Size(); ++i) {
+        if (out) *out << MoveToString(moves[i]) << ": " << subtreeNodes[i] << std::endl;
+        total += subtreeNodes[i];
+    }
+    return total;
+}
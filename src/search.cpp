@@ -0,0 +1,402 @@
+#include "search.h"
+#include <algorithm>
+#include <thread>
+#include "evaluate.h"
+#include "movepicker.h"
+
+std::string ScoreToString(int score) {
+    if (score >= VALUE_MATE_IN_MAX_PLY) return "mate " + std::to_string((VALUE_MATE - score + 1) / 2);
+    if (score <= -VALUE_MATE_IN_MAX_PLY) return "mate -" + std::to_string((VALUE_MATE + score) / 2);
+    return "cp " + std::to_string(score);
+}
+
+namespace {
+
+// Mate scores are stored relative to the node, not the root, so that an entry
+// reached again at a different ply still reports the right distance to mate.
+int ScoreToTT(int score, int ply) {
+    if (score >= VALUE_MATE_IN_MAX_PLY) return score + ply;
+    if (score <= -VALUE_MATE_IN_MAX_PLY) return score - ply;
+    return score;
+}
+
+int ScoreFromTT(int score, int ply) {
+    if (score >= VALUE_MATE_IN_MAX_PLY) return score - ply;
+    if (score <= -VALUE_MATE_IN_MAX_PLY) return score + ply;
+    return score;
+}
+
+}
+
+Searcher::Searcher(TranspositionTable& tt, int threadId, std::atomic<bool>* stopSignal)
+    : tt(tt), threadId(threadId), stopSignal(stopSignal), nodes(0), cutoffs(0), firstMoveCutoffs(0),
+      completedDepth(0), stopped(false), history(new MoveHistory()) {}
+
+double Searcher::Elapsed() const {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Depth 1 always finishes, so there is a move to return however tight the budget.
+void Searcher::CheckLimits() {
+    if (threadId != 0) {
+        if (stopSignal->load(std::memory_order_relaxed)) stopped = true;
+        return;
+    }
+    if (completedDepth == 0) return;
+    if (limits.nodes && nodes >= limits.nodes) stopped = true;
+    if (limits.milliseconds && Elapsed() * 1000 >= limits.milliseconds) stopped = true;
+}
+
+// Any earlier occurrence counts inside the tree: if the position was worth
+// repeating once, the side that benefits can repeat it again.
+bool Searcher::IsDraw() const {
+    return board.halfmoveClock >= 100
+        || keys.IsRepetition(board.key, board.halfmoveClock, 2)
+        || board.HasInsufficientMaterial();
+}
+
+SearchResult Searcher::Search(const Board& position, const KeyHistory& history, const SearchLimits& searchLimits,
+                              std::ostream* info) {
+    board = position;
+    keys = history;
+    limits = searchLimits;
+    start = std::chrono::steady_clock::now();
+    nodes = 0;
+    cutoffs = 0;
+    firstMoveCutoffs = 0;
+    completedDepth = 0;
+    stopped = false;
+    ttStats = TTStats();
+    rootBestMove = Move();
+    for (int ply = 0; ply < MAX_PLY; ++ply) {
+        killers[ply][0] = killers[ply][1] = Move();
+    }
+
+    SearchResult result;
+    MoveList rootMoves;
+    board.GenerateLegalMoves(rootMoves);
+    if (rootMoves.Empty()) {
+        result.score = board.IsKingInCheck(board.FindKingPosition()) ? -VALUE_MATE : VALUE_DRAW;
+        return result;
+    }
+
+    int maxDepth = std::min(std::max(limits.depth, 1), MAX_PLY - 1);
+    int score = 0;
+    for (int depth = 1 + (threadId & 1); depth <= maxDepth; ++depth) {
+        // Aspiration window around the last score, widened on each failure
+        // until the result falls inside it.
+        int delta = 25;
+        int alpha = -VALUE_INFINITE, beta = VALUE_INFINITE;
+        if (depth >= 4) {
+            alpha = std::max(score - delta, -VALUE_INFINITE);
+            beta = std::min(score + delta, VALUE_INFINITE);
+        }
+
+        while (true) {
+            int value = Negamax(alpha, beta, depth, 0);
+            if (stopped) break;
+
+            if (value <= alpha) {
+                beta = (alpha + beta) / 2;
+                alpha = std::max(value - delta, -VALUE_INFINITE);
+            } else if (value >= beta) {
+                beta = std::min(value + delta, VALUE_INFINITE);
+            } else {
+                score = value;
+                break;
+            }
+            delta *= 2;
+        }
+        if (stopped) break;
+
+        completedDepth = depth;
+        rootBestMove = pv[0][0];
+
+        result.bestMove = pv[0][0];
+        result.score = score;
+        result.depth = depth;
+        result.pv.assign(pv[0], pv[0] + pvLength[0]);
+        result.nodes = nodes;
+        result.seconds = Elapsed();
+        result.hashfull = tt.Hashfull();
+
+        if (info && threadId == 0) {
+            *info << "info depth " << depth << " score " << ScoreToString(score) << " nodes " << nodes
+                  << " nps " << result.Nps() << " hashfull " << result.hashfull
+                  << " time " << int64_t(result.seconds * 1000) << " pv";
+            for (const Move& move : result.pv) *info << ' ' << MoveToString(move);
+            *info << std::endl;
+        }
+
+        // Mate found within the horizon: deeper iterations cannot improve on it.
+        if (std::abs(score) >= VALUE_MATE_IN_MAX_PLY && VALUE_MATE - std::abs(score) <= depth) break;
+        // The next iteration takes several times longer than this one; do not
+        // start what cannot finish.
+        if (limits.milliseconds && result.seconds * 1000 * 2 >= limits.milliseconds) break;
+    }
+
+    result.nodes = nodes;
+    result.seconds = Elapsed();
+    result.ttStats = ttStats;
+    result.cutoffs = cutoffs;
+    result.firstMoveCutoffs = firstMoveCutoffs;
+    return result;
+}
+
+PieceToHistory* Searcher::Continuation(int ply, int back) const {
+    if (ply < back) return nullptr;
+    return &history->continuation[movedPiece[ply - back]][currentMove[ply - back].To()];
+}
+
+// Rewards the quiet move that caused a cutoff and penalises the quiets tried
+// before it, in the butterfly table and in the continuation tables of the
+// previous two moves, and makes it the countermove to the previous move.
+void Searcher::UpdateQuietHistories(int ply, Move best, const MoveList& quietsTried, int depth) {
+    int bonus = std::min(32 * depth * depth, 1600);
+    Colour us = board.currentTurn;
+    PieceToHistory* continuation[2] = {Continuation(ply, 1), Continuation(ply, 2)};
+
+    for (const Move& move : quietsTried) {
+        int delta = move == best ? bonus : -bonus;
+        Piece piece = board.PieceOn(move.From());
+        UpdateHistory(history->butterfly[us][move.From()][move.To()], delta);
+        for (PieceToHistory* table : continuation) {
+            if (table) UpdateHistory((*table)[piece][move.To()], delta);
+        }
+    }
+
+    if (ply > 0) {
+        history->counterMoves[movedPiece[ply - 1]][currentMove[ply - 1].To()] = best;
+    }
+}
+
+SearchPool::SearchPool(TranspositionTable& tt, int threads) : tt(tt), stop(false) {
+    SetThreads(threads);
+}
+
+void SearchPool::SetThreads(int threads) {
+    searchers.clear();
+    for (int id = 0; id < std::max(threads, 1); ++id) {
+        searchers.emplace_back(new Searcher(tt, id, &stop));
+    }
+}
+
+void SearchPool::Clear() {
+    tt.Clear();
+    for (std::unique_ptr<Searcher>& searcher : searchers) {
+        searcher->ClearHistory();
+    }
+}
+
+SearchResult SearchPool::Search(const Board& board, const KeyHistory& keys, const SearchLimits& limits,
+                                std::ostream* info) {
+    auto start = std::chrono::steady_clock::now();
+    tt.NewSearch();
+    stop = false;
+
+    // Helpers have no limits of their own; the main thread stops them.
+    SearchLimits helperLimits;
+    std::vector<SearchResult> helperResults(searchers.size());
+    std::vector<std::thread> helpers;
+    for (size_t id = 1; id < searchers.size(); ++id) {
+        helpers.emplace_back([&, id] {
+            helperResults[id] = searchers[id]->Search(board, keys, helperLimits);
+        });
+    }
+
+    SearchResult result = searchers[0]->Search(board, keys, limits, info);
+    stop = true;
+    for (std::thread& helper : helpers) {
+        helper.join();
+    }
+    // Wall time including the helpers' start-up and wind-down, so that nps
+    // reflects what the extra threads actually delivered.
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (size_t id = 1; id < searchers.size(); ++id) {
+        result.nodes += helperResults[id].nodes;
+        result.ttStats.probes += helperResults[id].ttStats.probes;
+        result.ttStats.hits += helperResults[id].ttStats.hits;
+        result.ttStats.stores += helperResults[id].ttStats.stores;
+        result.ttStats.collisions += helperResults[id].ttStats.collisions;
+        result.cutoffs += helperResults[id].cutoffs;
+        result.firstMoveCutoffs += helperResults[id].firstMoveCutoffs;
+    }
+    return result;
+}
+
+int Searcher::Negamax(int alpha, int beta, int depth, int ply) {
+    pvLength[ply] = ply;
+
+    bool inCheck = board.IsKingInCheck(board.FindKingPosition());
+    if (inCheck) depth++;
+    if (depth <= 0) return Quiescence(alpha, beta, ply);
+
+    if ((++nodes & 1023) == 0) CheckLimits();
+    if (stopped) return 0;
+
+    if (ply > 0) {
+        if (IsDraw()) return VALUE_DRAW;
+        if (ply >= MAX_PLY - 1) return Eval::Evaluate(board);
+
+        // A reversible move back into a position already on the search path
+        // will be available, so this node is worth at least a draw.
+        if (alpha < VALUE_DRAW && board.HasUpcomingRepetition(keys, ply)) {
+            alpha = VALUE_DRAW;
+            if (alpha >= beta) return alpha;
+        }
+
+        // No line from here can beat a mate already found nearer the root.
+        alpha = std::max(alpha, -VALUE_MATE + ply);
+        beta = std::min(beta, VALUE_MATE - ply - 1);
+        if (alpha >= beta) return alpha;
+    }
+
+    // Outside the principal variation a deep enough entry settles the node;
+    // on it the search goes on so that the full line can be reported.
+    bool pvNode = beta - alpha > 1;
+    TTData entry;
+    Move hashMove;
+    if (tt.Probe(board.key, entry, ttStats)) {
+        hashMove = entry.move;
+        int ttScore = ScoreFromTT(entry.score, ply);
+        if (!pvNode && entry.depth >= depth
+            && (entry.bound == BOUND_EXACT
+                || (entry.bound == BOUND_LOWER && ttScore >= beta)
+                || (entry.bound == BOUND_UPPER && ttScore <= alpha))) {
+            return ttScore;
+        }
+    }
+    if (ply == 0 && hashMove.IsNone()) hashMove = rootBestMove;
+
+    Move counterMove = ply > 0 ? history->counterMoves[movedPiece[ply - 1]][currentMove[ply - 1].To()] : Move();
+    MovePicker picker(board, hashMove, killers[ply][0], killers[ply][1], counterMove, history.get(),
+                      Continuation(ply, 1), Continuation(ply, 2));
+
+    int originalAlpha = alpha;
+    int bestScore = -VALUE_INFINITE;
+    Move bestMove;
+    int moveCount = 0;
+    MoveList quietsTried;
+    Move move;
+    while (!(move = picker.Next()).IsNone()) {
+        moveCount++;
+        bool capture = board.IsCapture(move);
+        if (!capture) quietsTried.Add(move);
+        currentMove[ply] = move;
+        movedPiece[ply] = board.PieceOn(move.From());
+
+        UndoInfo undo;
+        keys.Push(board.key);
+        board.MakeMove(move, undo);
+
+        // Principal variation search: the first move gets the full window, the
+        // rest only have to prove they are no better, and are searched again
+        // with the full window when they are.
+        int score;
+        if (moveCount == 1) {
+            score = -Negamax(-beta, -alpha, depth - 1, ply + 1);
+        } else {
+            score = -Negamax(-alpha - 1, -alpha, depth - 1, ply + 1);
+            if (score > alpha && score < beta) {
+                score = -Negamax(-beta, -alpha, depth - 1, ply + 1);
+            }
+        }
+
+        board.UnmakeMove(undo);
+        keys.Pop();
+        if (stopped) return 0;
+
+        if (score > bestScore) {
+            bestScore = score;
+            if (score > alpha) {
+                alpha = score;
+                bestMove = move;
+                pv[ply][ply] = move;
+                std::copy(pv[ply + 1] + ply + 1, pv[ply + 1] + pvLength[ply + 1], pv[ply] + ply + 1);
+                pvLength[ply] = std::max(pvLength[ply + 1], ply + 1);
+
+                if (alpha >= beta) {
+                    cutoffs++;
+                    if (moveCount == 1) firstMoveCutoffs++;
+                    if (!capture) {
+                        if (move != killers[ply][0]) {
+                            killers[ply][1] = killers[ply][0];
+                            killers[ply][0] = move;
+                        }
+                        UpdateQuietHistories(ply, move, quietsTried, depth);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    if (moveCount == 0) {
+        return inCheck ? -VALUE_MATE + ply : VALUE_DRAW;
+    }
+
+    Bound bound = bestScore >= beta ? BOUND_LOWER : bestScore > originalAlpha ? BOUND_EXACT : BOUND_UPPER;
+    tt.Store(board.key, bestMove, ScoreToTT(bestScore, ply), depth, bound, ttStats);
+    return bestScore;
+}
+
+// Captures only, until the position is quiet, so the static evaluation is never
+// taken in the middle of an exchange. The side to move may stand pat unless it
+// is in check, in which case every evasion is searched. Captures that lose
+// material by SEE are never searched: standing pat is at least as good.
+int Searcher::Quiescence(int alpha, int beta, int ply) {
+    pvLength[ply] = ply;
+
+    if ((++nodes & 1023) == 0) CheckLimits();
+    if (stopped) return 0;
+    if (ply > 0 && IsDraw()) return VALUE_DRAW;
+
+    bool inCheck = board.IsKingInCheck(board.FindKingPosition());
+    if (ply >= MAX_PLY - 1) return inCheck ? VALUE_DRAW : Eval::Evaluate(board);
+
+    // Every entry is at least as deep as a quiescence search.
+    TTData entry;
+    if (tt.Probe(board.key, entry, ttStats)) {
+        int ttScore = ScoreFromTT(entry.score, ply);
+        if (entry.bound == BOUND_EXACT
+            || (entry.bound == BOUND_LOWER && ttScore >= beta)
+            || (entry.bound == BOUND_UPPER && ttScore <= alpha)) {
+            return ttScore;
+        }
+    }
+
+    int originalAlpha = alpha;
+    Move bestMove;
+    int bestScore = -VALUE_MATE + ply;
+    if (!inCheck) {
+        bestScore = Eval::Evaluate(board);
+        if (bestScore >= beta) return bestScore;
+        alpha = std::max(alpha, bestScore);
+    }
+
+    MovePicker picker = inCheck ? MovePicker(board, Move(), Move(), Move()) : MovePicker(board);
+    Move move;
+    while (!(move = picker.Next()).IsNone()) {
+        UndoInfo undo;
+        keys.Push(board.key);
+        board.MakeMove(move, undo);
+        int score = -Quiescence(-beta, -alpha, ply + 1);
+        board.UnmakeMove(undo);
+        keys.Pop();
+        if (stopped) return 0;
+
+        if (score > bestScore) {
+            bestScore = score;
+            if (score > alpha) {
+                alpha = score;
+                bestMove = move;
+                if (alpha >= beta) break;
+            }
+        }
+    }
+
+    Bound bound = bestScore >= beta ? BOUND_LOWER : bestScore > originalAlpha ? BOUND_EXACT : BOUND_UPPER;
+    tt.Store(board.key, bestMove, ScoreToTT(bestScore, ply), 0, bound, ttStats);
+    return bestScore;
+}
@@ -0,0 +1,127 @@
+#include "tt.h"
+#include <algorithm>
+
+TranspositionTable::TranspositionTable(size_t megabytes) : bucketCount(0), generation(0) {
+    Resize(megabytes);
+}
+
+void TranspositionTable::Resize(size_t megabytes) {
+    size_t count = 1;
+    while (count * 2 * sizeof(Bucket) <= megabytes * 1024 * 1024) {
+        count *= 2;
+    }
+
+    buckets.reset(new Bucket[count]);
+    bucketCount = count;
+    Clear();
+}
+
+void TranspositionTable::Clear() {
+    for (size_t i = 0; i < bucketCount; ++i) {
+        for (Entry& entry : buckets[i].entries) {
+            entry.check.store(0, std::memory_order_relaxed);
+            entry.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    generation = 0;
+}
+
+uint64_t TranspositionTable::Pack(Move move, int score, int depth, Bound bound, int generation) {
+    return uint64_t(move.Raw())
+         | uint64_t(uint16_t(int16_t(score))) << 16
+         | uint64_t(uint8_t(int8_t(depth))) << 32
+         | uint64_t(bound) << 40
+         | uint64_t(generation) << 42;
+}
+
+TTData TranspositionTable::Unpack(uint64_t data) {
+    TTData result;
+    result.move = Move::FromRaw(uint16_t(data));
+    result.score = int16_t(uint16_t(data >> 16));
+    result.depth = int8_t(uint8_t(data >> 32));
+    result.bound = Bound((data >> 40) & 3);
+    return result;
+}
+
+// An empty slot verifies only for key 0, and its BOUND_NONE marks it unused.
+bool TranspositionTable::Probe(Key key, TTData& result, TTStats& stats) {
+    stats.probes++;
+    Bucket& bucket = BucketFor(key);
+    for (Entry& entry : bucket.entries) {
+        uint64_t data = entry.data.load(std::memory_order_relaxed);
+        uint64_t check = entry.check.load(std::memory_order_relaxed);
+        if ((check ^ data) != key) continue;
+
+        TTData found = Unpack(data);
+        if (found.bound == BOUND_NONE) continue;
+
+        // Refresh the age so a position still in use is not replaced first.
+        if (GenerationOf(data) != generation) {
+            uint64_t refreshed = (data & ~(uint64_t(GENERATION_MASK) << 42)) | uint64_t(generation) << 42;
+            entry.check.store(key ^ refreshed, std::memory_order_relaxed);
+            entry.data.store(refreshed, std::memory_order_relaxed);
+        }
+        stats.hits++;
+        result = found;
+        return true;
+    }
+    return false;
+}
+
+void TranspositionTable::Store(Key key, Move move, int score, int depth, Bound bound, TTStats& stats) {
+    Bucket& bucket = BucketFor(key);
+    Entry* replace = nullptr;
+    int replaceWorth = 0;
+    uint64_t replaceData = 0;
+
+    for (Entry& entry : bucket.entries) {
+        uint64_t data = entry.data.load(std::memory_order_relaxed);
+        uint64_t check = entry.check.load(std::memory_order_relaxed);
+
+        // Same position: always the slot to use.
+        if ((check ^ data) == key) {
+            TTData old = Unpack(data);
+            // Keep a much deeper entry from this search over a new result
+            // that is only a bound.
+            if (bound != BOUND_EXACT && depth < old.depth - 2 && GenerationOf(data) == generation) {
+                return;
+            }
+            if (move.IsNone()) move = old.move;
+            replace = &entry;
+            replaceData = 0;
+            break;
+        }
+
+        // Otherwise replace the least valuable entry: empty slots, then
+        // results from earlier searches, then shallow ones.
+        TTData other = Unpack(data);
+        int age = (generation - GenerationOf(data)) & GENERATION_MASK;
+        int worth = other.bound == BOUND_NONE ? -1000 : other.depth - 8 * age;
+        if (!replace || worth < replaceWorth) {
+            replace = &entry;
+            replaceWorth = worth;
+            replaceData = data;
+        }
+    }
+
+    stats.stores++;
+    if (replaceData && Unpack(replaceData).bound != BOUND_NONE && GenerationOf(replaceData) == generation) {
+        stats.collisions++;
+    }
+
+    uint64_t data = Pack(move, score, depth, bound, generation);
+    replace->check.store(key ^ data, std::memory_order_relaxed);
+    replace->data.store(data, std::memory_order_relaxed);
+}
+
+int TranspositionTable::Hashfull() const {
+    size_t sampledBuckets = std::min(bucketCount, size_t(1000 / BUCKET_SIZE));
+    int used = 0;
+    for (size_t i = 0; i < sampledBuckets; ++i) {
+        for (const Entry& entry : buckets[i].entries) {
+            uint64_t data = entry.data.load(std::memory_order_relaxed);
+            if (Bound((data >> 40) & 3) != BOUND_NONE && GenerationOf(data) == generation) used++;
+        }
+    }
+    return int(used * 1000 / (sampledBuckets * BUCKET_SIZE));
+}
@@ -0,0 +1,55 @@
+#include "zobrist.h"
+#include "cuckoo.h"
+
+namespace Zobrist {
+
+Key PieceSquare[2][7][64];
+Key Castling[16];
+Key EnPassantFile[8];
+Key SideToMove;
+
+namespace {
+
+// xorshift64* with a fixed seed so keys are identical across runs and processes.
+Key NextRandom(Key& state) {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 2685821657736338717ULL;
+}
+
+}
+
+void Init() {
+    Key state = 1070372ULL;
+
+    for (int colour = 0; colour < 2; ++colour) {
+        for (int type = 0; type < 7; ++type) {
+            for (int square = 0; square < 64; ++square) {
+                PieceSquare[colour][type][square] = NextRandom(state);
+            }
+        }
+    }
+
+    // Each right gets its own key and combinations are their XOR, so a
+    // rights change is one lookup for the old mask and one for the new.
+    Key rightKeys[4];
+    for (int i = 0; i < 4; ++i) {
+        rightKeys[i] = NextRandom(state);
+    }
+    for (int rights = 0; rights < 16; ++rights) {
+        Castling[rights] = 0;
+        for (int i = 0; i < 4; ++i) {
+            if (rights & (1 << i)) Castling[rights] ^= rightKeys[i];
+        }
+    }
+
+    for (int file = 0; file < 8; ++file) {
+        EnPassantFile[file] = NextRandom(state);
+    }
+    SideToMove = NextRandom(state);
+
+    Cuckoo::Init();
+}
+
+}
@@ -0,0 +1,254 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <algorithm>
+#include <vector>
+#include "board.h"
+#include "search.h"
+
+namespace {
+
+const std::string START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+// A spread of openings, middlegames and endgames, searched the same way on
+// every run so that node counts and speeds can be compared between builds.
+const std::string benchPositions[] = {
+    START_FEN,
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3",
+    "r1bq1rk1/pp2ppbp/2np1np1/8/3NP3/2N1BP2/PPPQ2PP/R3KB1R w KQ - 3 9",
+    "2r3k1/pp3ppp/4p3/3pP3/3P4/P7/1P3PPP/3R2K1 w - - 0 25",
+    "8/8/4k3/3p4/3P4/4K3/8/8 w - - 0 1",
+    "4r1k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1",
+    "8/5pk1/6p1/7p/1R5P/6P1/r4PK1/8 b - - 0 40",
+};
+
+struct BenchTotals {
+    uint64_t nodes = 0;
+    double seconds = 0;
+    TTStats ttStats;
+    int hashfull = 0;
+    uint64_t cutoffs = 0;
+    uint64_t firstMoveCutoffs = 0;
+};
+
+BenchTotals RunBench(SearchPool& pool, const std::vector<std::string>& fens,
+                     const SearchLimits& limits, bool info, bool verbose) {
+    Board board;
+    KeyHistory keys;
+    BenchTotals totals;
+
+    for (size_t i = 0; i < fens.size(); ++i) {
+        // Each position starts from an empty table and empty histories, so
+        // node counts do not depend on which positions ran before it.
+        pool.Clear();
+        board.LoadPositionFromFen(fens[i]);
+        SearchResult result = pool.Search(board, keys, limits, info ? &std::cout : nullptr);
+        totals.nodes += result.nodes;
+        totals.seconds += result.seconds;
+        totals.ttStats.probes += result.ttStats.probes;
+        totals.ttStats.hits += result.ttStats.hits;
+        totals.ttStats.stores += result.ttStats.stores;
+        totals.ttStats.collisions += result.ttStats.collisions;
+        totals.hashfull = std::max(totals.hashfull, result.hashfull);
+        totals.cutoffs += result.cutoffs;
+        totals.firstMoveCutoffs += result.firstMoveCutoffs;
+
+        if (!verbose) continue;
+        std::cout << "Position " << std::setw(2) << i + 1 << ": bestmove " << std::setw(5) << std::left
+                  << (result.bestMove.IsNone() ? "none" : MoveToString(result.bestMove)) << std::right
+                  << " score " << std::setw(9) << ScoreToString(result.score) << " depth " << std::setw(2) << result.depth
+                  << " nodes " << std::setw(10) << result.nodes << " nps " << result.Nps() << std::endl;
+    }
+    return totals;
+}
+
+// Time to reach the same depth on every position, for a growing number of
+// threads. Lazy SMP also searches more nodes per iteration as threads are
+// added, so this, not nps, is the measure of what the extra cores buy.
+int RunSpeedup(TranspositionTable& tt, const std::vector<std::string>& fens, SearchLimits limits, int maxThreads) {
+    limits.nodes = 0;
+    limits.milliseconds = 0;
+    std::vector<int> counts;
+    for (int threads = 1; threads < maxThreads; threads *= 2) {
+        counts.push_back(threads);
+    }
+    counts.push_back(maxThreads);
+
+    std::cout << "Time to depth " << limits.depth << " over " << fens.size() << " positions\n" << std::endl;
+    std::cout << std::setw(8) << "threads" << std::setw(12) << "time (s)" << std::setw(10) << "speedup"
+              << std::setw(14) << "nodes" << std::setw(14) << "nps" << std::endl;
+
+    SearchPool pool(tt, 1);
+    double baseline = 0;
+    for (int threads : counts) {
+        pool.SetThreads(threads);
+        BenchTotals totals = RunBench(pool, fens, limits, false, false);
+        if (threads == 1) baseline = totals.seconds;
+
+        std::cout << std::setw(8) << threads << std::setw(12) << std::fixed << std::setprecision(3) << totals.seconds
+                  << std::setw(10) << std::setprecision(2) << (totals.seconds > 0 ? baseline / totals.seconds : 0.0)
+                  << std::setw(14) << totals.nodes
+                  << std::setw(14) << uint64_t(totals.seconds > 0 ? totals.nodes / totals.seconds : 0) << std::endl;
+    }
+    return 0;
+}
+
+void PrintUsage() {
+    std::cout << "Usage: Bench [options]                         search the bench positions\n"
+              << "       Bench [options] <fen>                   search one position\n"
+              << "Options:\n"
+              << "       --depth <n>     iterations to complete (default 8)\n"
+              << "       --nodes <n>     stop after about n nodes per position\n"
+              << "       --movetime <ms> stop after ms milliseconds per position\n"
+              << "       --hash <mb>     transposition table size (default 16)\n"
+              << "       --threads <n>   search threads (default 1)\n"
+              << "       --speedup <n>   time the fixed-depth bench with 1, 2, 4 ... n threads\n"
+              << "       --see           time static exchange evaluation instead of searching\n"
+              << "       --info          print a line per iteration\n"
+              << "       --slider <auto|magic|pext>  slider attack backend (default auto)" << std::endl;
+}
+
+// Every capture in the bench positions and in the positions two plies below
+// them, each evaluated over and over, so the figure reflects SEE on the kind of
+// exchanges a search actually meets.
+int RunSeeBench(const std::vector<std::string>& fens) {
+    struct Sample {
+        Board board;
+        Move move;
+    };
+    std::vector<Sample> samples;
+    auto collect = [&](const Board& board) {
+        MoveList captures;
+        board.GenerateCaptures(captures);
+        for (const Move& move : captures) samples.push_back({board, move});
+    };
+
+    for (const std::string& fen : fens) {
+        Board board;
+        board.LoadPositionFromFen(fen);
+        collect(board);
+        MoveList moves;
+        board.GenerateLegalMoves(moves);
+        for (const Move& move : moves) {
+            UndoInfo undo;
+            board.MakeMove(move, undo);
+            collect(board);
+            MoveList replies;
+            board.GenerateLegalMoves(replies);
+            for (const Move& reply : replies) {
+                UndoInfo replyUndo;
+                board.MakeMove(reply, replyUndo);
+                collect(board);
+                board.UnmakeMove(replyUndo);
+            }
+            board.UnmakeMove(undo);
+        }
+    }
+    if (samples.empty()) {
+        std::cout << "No captures to evaluate" << std::endl;
+        return 1;
+    }
+
+    const uint64_t calls = 20000000;
+    uint64_t winning = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < calls; ++i) {
+        const Sample& sample = samples[i % samples.size()];
+        winning += sample.board.SeeGe(sample.move, 0);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "SEE: " << samples.size() << " captures, " << calls << " calls in " << std::fixed << std::setprecision(3)
+              << seconds << " s  " << uint64_t(calls / seconds) << " calls/s  (" << std::setprecision(1)
+              << 100.0 * winning / calls << "% not losing)" << std::endl;
+    return 0;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    int arg = 1;
+    SearchLimits limits;
+    limits.depth = 8;
+    size_t hashMegabytes = 16;
+    int threads = 1;
+    int speedupThreads = 0;
+    bool see = false;
+    bool info = false;
+    SliderBackend slider = SLIDER_AUTO;
+    for (; arg < argc && std::string(argv[arg]).rfind("--", 0) == 0; arg++) {
+        std::string option = argv[arg];
+        if (option == "--depth" && arg + 1 < argc) {
+            limits.depth = std::max(1, std::atoi(argv[++arg]));
+        } else if (option == "--nodes" && arg + 1 < argc) {
+            limits.nodes = std::strtoull(argv[++arg], nullptr, 10);
+            limits.depth = MAX_PLY - 1;
+        } else if (option == "--movetime" && arg + 1 < argc) {
+            limits.milliseconds = std::max(1, std::atoi(argv[++arg]));
+            limits.depth = MAX_PLY - 1;
+        } else if (option == "--hash" && arg + 1 < argc) {
+            hashMegabytes = std::max(1, std::atoi(argv[++arg]));
+        } else if (option == "--threads" && arg + 1 < argc) {
+            threads = std::max(1, std::atoi(argv[++arg]));
+        } else if (option == "--speedup" && arg + 1 < argc) {
+            speedupThreads = std::max(1, std::atoi(argv[++arg]));
+        } else if (option == "--see") {
+            see = true;
+        } else if (option == "--info") {
+            info = true;
+        } else if (option == "--slider" && arg + 1 < argc && Bitboards::ParseSliderBackend(argv[arg + 1], slider)) {
+            arg++;
+        } else {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    Bitboards::Init(slider);
+    Zobrist::Init();
+    std::cout << "Slider attacks: " << Bitboards::SliderBackendName()
+              << (Bitboards::CpuHasPext() ? "" : " (no BMI2 on this CPU)") << "\n"
+              << "Attack tables: " << Bitboards::TableBytes() / 1024 << " KB built in "
+              << Bitboards::InitMicroseconds << " us\n" << std::endl;
+
+    std::vector<std::string> fens(std::begin(benchPositions), std::end(benchPositions));
+    if (arg < argc) {
+        std::string fen;
+        for (; arg < argc; arg++) {
+            if (!fen.empty()) fen += ' ';
+            fen += argv[arg];
+        }
+        fens.assign(1, fen);
+    }
+
+    if (see) {
+        return RunSeeBench(fens);
+    }
+
+    TranspositionTable tt(hashMegabytes);
+    if (speedupThreads > 0) {
+        return RunSpeedup(tt, fens, limits, speedupThreads);
+    }
+
+    SearchPool pool(tt, threads);
+    std::cout << "Threads: " << pool.Threads() << "\n" << std::endl;
+    BenchTotals totals = RunBench(pool, fens, limits, info, true);
+
+    std::cout << "\nTotal nodes: " << totals.nodes << "  time: " << std::fixed << std::setprecision(3) << totals.seconds
+              << " s  nps: " << uint64_t(totals.seconds > 0 ? totals.nodes / totals.seconds : 0) << std::endl;
+    std::cout << "Hash: " << tt.Megabytes() << " MB  hits " << std::setprecision(1)
+              << (totals.ttStats.probes ? 100.0 * totals.ttStats.hits / totals.ttStats.probes : 0.0) << "% of "
+              << totals.ttStats.probes << " probes  collisions "
+              << (totals.ttStats.stores ? 100.0 * totals.ttStats.collisions / totals.ttStats.stores : 0.0) << "% of "
+              << totals.ttStats.stores << " stores  peak hashfull " << totals.hashfull << std::endl;
+    std::cout << "First-move cutoffs: " << (totals.cutoffs ? 100.0 * totals.firstMoveCutoffs / totals.cutoffs : 0.0)
+              << "% of " << totals.cutoffs << " cutoffs" << std::endl;
+    return 0;
+}
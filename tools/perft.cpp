@@ -0,0 +1,158 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "board.h"
+#include "perft.h"
+
+namespace {
+
+const std::string START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+struct ReferencePosition {
+    std::string name;
+    std::string fen;
+    int depth;
+    uint64_t expected;
+};
+
+// Published counts from the Chess Programming Wiki perft results page.
+const ReferencePosition referencePositions[] = {
+    {"Start position", START_FEN, 5, 4865609},
+    {"Kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 4, 4085603},
+    {"Position 3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 6, 11030083},
+    {"Position 4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 5, 15833292},
+    {"Position 4 mirrored", "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1", 5, 15833292},
+    {"Position 5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 4, 2103487},
+    {"Position 6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 4, 3894594},
+};
+
+double SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void PrintUsage() {
+    std::cout << "Usage: Perft [options]                         run the reference positions\n"
+              << "       Perft [options] <depth> [fen]           count leaf nodes\n"
+              << "Options:\n"
+              << "       --divide       print the count under each root move\n"
+              << "       --threads <n>  split the root moves across n threads\n"
+              << "       --hash <mb>    share an n MB subtree hash between threads\n"
+              << "       --slider <auto|magic|pext>  slider attack backend (default auto)" << std::endl;
+}
+
+void PrintThreadReport(const std::vector<PerftStats>& threadStats, bool hashed) {
+    uint64_t probes = 0, hits = 0;
+    for (size_t id = 0; id < threadStats.size(); ++id) {
+        std::cout << "Thread " << id << ": " << threadStats[id].nodes << " nodes" << std::endl;
+        probes += threadStats[id].probes;
+        hits += threadStats[id].hits;
+    }
+    if (hashed) {
+        std::cout << "Hash: " << hits << " hits / " << probes << " probes (" << std::fixed << std::setprecision(1)
+                  << (probes ? 100.0 * hits / probes : 0.0) << "%)" << std::endl;
+    }
+}
+
+int RunReferenceSuite(Board& board) {
+    int failures = 0;
+    uint64_t totalNodes = 0;
+    double totalSeconds = 0;
+
+    for (const ReferencePosition& position : referencePositions) {
+        board.LoadPositionFromFen(position.fen);
+        auto start = std::chrono::steady_clock::now();
+        uint64_t nodes = Perft(board, position.depth);
+        double seconds = SecondsSince(start);
+
+        totalNodes += nodes;
+        totalSeconds += seconds;
+        bool passed = nodes == position.expected;
+        if (!passed) failures++;
+
+        std::cout << std::left << std::setw(22) << position.name << " depth " << position.depth
+                  << "  nodes " << std::setw(10) << nodes << " expected " << std::setw(10) << position.expected
+                  << (passed ? " PASS" : " FAIL") << std::endl;
+    }
+
+    std::cout << "\nTotal nodes: " << totalNodes << "  time: " << std::fixed << std::setprecision(3) << totalSeconds
+              << " s  nps: " << uint64_t(totalNodes / totalSeconds) << std::endl;
+    return failures == 0 ? 0 : 1;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    int arg = 1;
+    bool divide = false;
+    int threads = 1;
+    size_t hashMegabytes = 0;
+    SliderBackend slider = SLIDER_AUTO;
+    for (; arg < argc && std::string(argv[arg]).rfind("--", 0) == 0; arg++) {
+        std::string option = argv[arg];
+        if (option == "--divide") {
+            divide = true;
+        } else if (option == "--threads" && arg + 1 < argc) {
+            threads = std::max(1, std::atoi(argv[++arg]));
+        } else if (option == "--hash" && arg + 1 < argc) {
+            hashMegabytes = std::max(0, std::atoi(argv[++arg]));
+        } else if (option == "--slider" && arg + 1 < argc && Bitboards::ParseSliderBackend(argv[arg + 1], slider)) {
+            arg++;
+        } else {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    Bitboards::Init(slider);
+    Zobrist::Init();
+    Board board;
+    std::cout << "Slider attacks: " << Bitboards::SliderBackendName()
+              << (Bitboards::CpuHasPext() ? "" : " (no BMI2 on this CPU)") << "\n"
+              << "Attack tables: " << Bitboards::TableBytes() / 1024 << " KB built in "
+              << Bitboards::InitMicroseconds << " us\n" << std::endl;
+
+    if (arg >= argc) {
+        return RunReferenceSuite(board);
+    }
+
+    int depth = std::atoi(argv[arg++]);
+    if (depth < 1) {
+        PrintUsage();
+        return 1;
+    }
+
+    std::string fen;
+    for (; arg < argc; arg++) {
+        if (!fen.empty()) fen += ' ';
+        fen += argv[arg];
+    }
+    board.LoadPositionFromFen(fen.empty() ? START_FEN : fen);
+
+    std::unique_ptr<PerftHash> hash;
+    if (hashMegabytes > 0) hash.reset(new PerftHash(hashMegabytes));
+    bool parallel = threads > 1 || hash;
+
+    std::vector<PerftStats> threadStats;
+    auto start = std::chrono::steady_clock::now();
+    uint64_t nodes;
+    if (parallel) {
+        nodes = ParallelPerft(board, depth, threads, hash.get(), threadStats, divide ? &std::cout : nullptr);
+    } else {
+        nodes = divide ? PerftDivide(board, depth, std::cout) : Perft(board, depth);
+    }
+    double seconds = SecondsSince(start);
+
+    if (parallel) {
+        std::cout << std::endl;
+        PrintThreadReport(threadStats, hash != nullptr);
+    }
+
+    std::cout << "\nNodes: " << nodes << "\nTime: " << std::fixed << std::setprecision(3) << seconds
+              << " s\nNPS: " << uint64_t(nodes / seconds) << std::endl;
+    return 0;
+}